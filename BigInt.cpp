@@ -1,833 +1,3316 @@
 #include "BigInt.hpp"
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <future>
+#include <thread>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
 /**
- * @brief Default constructor. Value is automatically set to zero, and sign is automatically positive.
- * 默认构造函数。值自动设为零，符号自动设为正。
+ * @brief Environment variable holding the path of the tuning profile.
+ * 保存调优配置文件路径的环境变量。
  */
-BigInt::BigInt()
+static const char *TUNING_ENV = "BIGINT_TUNING";
+
+/**
+ * @brief Tuning profile read when the environment variable is not set.
+ * 未设置环境变量时读取的调优配置文件。
+ */
+static const char *TUNING_DEFAULT_PATH = "bigint_tuning.txt";
+
+/**
+ * @brief Bytes currently allocated by all digit buffers, updated by DigitAllocator.
+ * 所有数字缓冲区当前分配的字节数，由 DigitAllocator 更新。
+ *
+ * @return atomic<size_t>&
+ */
+atomic<size_t> &liveDigitBytes()
 {
-    this->digits = vector<uint8_t>();
-    this->digits.push_back(0);
-    this->sign = true;
+    static atomic<size_t> bytes(0);
+    return bytes;
 }
 
 /**
- * @brief Initializes with a signed 64-bit integer.
- * 使用signed 64-bit integer进行初始化。
+ * @brief Storage of the thresholds in use. The profile is loaded once, on first use.
+ * 当前使用的阈值的存储。调优配置文件只在首次使用时加载一次。
  *
- * @param value The signed 64-bit integer to initialize with.传入的signed 64-bit integer。
+ * @return BigIntTuning&
  */
-BigInt::BigInt(int64_t value)
+static BigIntTuning &tuningStorage()
 {
-    this->digits = vector<uint8_t>();
-    // Initialize sign
-    // 初始化符号
-    if (value >= 0)
+    static BigIntTuning tuning = []()
     {
-        this->sign = true;
-    }
-    else
+        BigIntTuning loaded = BigInt::defaultTuning();
+        const char *path = getenv(TUNING_ENV);
+        // Fall back to the compiled-in defaults when there is no profile
+        // 没有调优配置文件时使用编译时内置的默认值
+        if (!BigInt::loadTuning(path != nullptr ? path : TUNING_DEFAULT_PATH, loaded))
+        {
+            loaded = BigInt::defaultTuning();
+        }
+        return loaded;
+    }();
+    return tuning;
+}
+
+/**
+ * @brief Load the tuning profile at program startup rather than in the middle of the first multiplication.
+ * 在程序启动时加载调优配置文件，而不是在第一次乘法的过程中加载。
+ */
+static const BigIntTuning &startupTuning = tuningStorage();
+
+/**
+ * @brief Builds the exception thrown at a cancelled safe point.
+ * 构造在已取消的安全点抛出的异常。
+ *
+ * @param reason
+ */
+BigIntCancelled::BigIntCancelled(const string &reason) : runtime_error(reason)
+{
+}
+
+/**
+ * @brief Creates a token that is not cancelled, has no deadline and no progress.
+ * 创建未取消、无截止时间、无进度的令牌。
+ */
+BigIntCancelToken::BigIntCancelToken() : state(make_shared<State>())
+{
+    this->state->cancelled = false;
+    this->state->deadlineNs = INT64_MAX;
+    this->state->progress = 0;
+}
+
+/**
+ * @brief Requests cancellation, the operation stops at its next safe point.
+ * 请求取消，运算在下一个安全点停止。
+ */
+void BigIntCancelToken::cancel() const
+{
+    this->state->cancelled = true;
+}
+
+/**
+ * @brief Sets the deadline after which the operation is cancelled.
+ * 设置截止时间，超过后运算被取消。
+ *
+ * @param deadline
+ */
+void BigIntCancelToken::setDeadline(chrono::steady_clock::time_point deadline) const
+{
+    this->state->deadlineNs = chrono::duration_cast<chrono::nanoseconds>(deadline.time_since_epoch()).count();
+}
+
+/**
+ * @brief Whether the operation was cancelled or is past its deadline.
+ * 运算是否已被取消或已超过截止时间。
+ *
+ * @return true
+ * @return false
+ */
+bool BigIntCancelToken::expired() const
+{
+    if (this->state->cancelled)
     {
-        this->sign = false;
-        value = -value;
+        return true;
     }
-    // Little-endian storage
-    // 小端存储
-    // If the input value is 0, then assign directly
-    // 如果传入值为0则直接赋值
-    if (value == 0)
+    int64_t deadline = this->state->deadlineNs;
+    return deadline != INT64_MAX &&
+           chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count() >= deadline;
+}
+
+/**
+ * @brief Safe point: throws BigIntCancelled when the operation was cancelled or is past its deadline.
+ * 安全点：运算已被取消或已超过截止时间时抛出 BigIntCancelled。
+ */
+void BigIntCancelToken::check() const
+{
+    if (this->state->cancelled)
     {
-        this->sign = true;
-        this->digits.push_back(0);
+        throw BigIntCancelled("Operation cancelled");
     }
-    // Otherwise, split the input value and store
-    // 否则拆分传入值并储存
-    else
+    if (this->expired())
     {
-        while (value != 0)
-        {
-            this->digits.push_back(static_cast<uint8_t>(value % 10));
-            value /= 10;
-        }
+        throw BigIntCancelled("Deadline exceeded");
     }
 }
 
 /**
- * @brief Initializes from a string.
- * 从string初始化。
+ * @brief Fraction of the work done.
+ * 已完成的工作比例。
  *
- * @param value The string to initialize from. 传入的string。
+ * @return double From 0 to 1. 从0到1。
  */
-BigInt::BigInt(const string &value)
+double BigIntCancelToken::progress() const
 {
-    this->digits = vector<uint8_t>();
+    return this->state->progress;
+}
 
-    auto rend = value.rend();
-    // Check the sign of the input number (string), start from index 1 to ignore the sign if it exists
-    // 检测输入数字（字符串）的符号，如果有符号就从下标1开始来忽略符号
-    if (value[0] == '-')
+/**
+ * @brief Records the fraction of the work done.
+ * 记录已完成的工作比例。
+ *
+ * @param fraction From 0 to 1. 从0到1。
+ */
+void BigIntCancelToken::setProgress(double fraction) const
+{
+    this->state->progress = fraction;
+}
+
+/**
+ * @brief Token checked by the kernels of this thread.
+ * 本线程的内核所检查的令牌。
+ *
+ * @return const BigIntCancelToken*&
+ */
+static const BigIntCancelToken *&threadToken()
+{
+    thread_local const BigIntCancelToken *token = nullptr;
+    return token;
+}
+
+/**
+ * @brief Installs token for the kernels of this thread, remembering the enclosing one.
+ * 为本线程的内核设置令牌，并记住外层的令牌。
+ *
+ * @param token
+ */
+BigIntCancelScope::BigIntCancelScope(const BigIntCancelToken &token) : previous(threadToken())
+{
+    threadToken() = &token;
+}
+
+/**
+ * @brief Restores the enclosing token.
+ * 恢复外层的令牌。
+ */
+BigIntCancelScope::~BigIntCancelScope()
+{
+    threadToken() = this->previous;
+}
+
+/**
+ * @brief Token of the innermost scope on this thread.
+ * 本线程最内层作用域的令牌。
+ *
+ * @return const BigIntCancelToken* Null outside any scope. 不在任何作用域内时为空。
+ */
+const BigIntCancelToken *BigIntCancelScope::current()
+{
+    return threadToken();
+}
+
+/**
+ * @brief Safe point for the loops of division, gcd, radix conversion and primality testing, which report no
+ * progress but throw BigIntCancelled when the token of the innermost scope is cancelled or past its deadline.
+ * 除法、最大公约数、进制转换和素性测试的循环中的安全点，不报告进度，但最内层作用域的令牌已取消或超过截止时间时
+ * 抛出 BigIntCancelled。
+ */
+void BigIntCancelScope::checkpoint()
+{
+    const BigIntCancelToken *token = threadToken();
+    if (token != nullptr)
     {
-        this->sign = false;
-        rend--;
+        token->check();
     }
-    else if (value[0] == '+')
+}
+
+/**
+ * @brief Progress of the multiplication running on this thread under a token, counted in work units
+ * (Karatsuba leaves, slices or schoolbook rows).
+ * 本线程上在令牌下运行的乘法的进度，以工作单元计（Karatsuba 叶子、切片或手算乘法的行）。
+ */
+struct MultiplyProgress
+{
+    const BigIntCancelToken *token;
+    uint64_t done;
+    uint64_t total;
+};
+
+/**
+ * @brief The multiplication progress of this thread, token is null when nothing is tracked.
+ * 本线程的乘法进度，不跟踪时 token 为空。
+ *
+ * @return MultiplyProgress&
+ */
+static MultiplyProgress &threadProgress()
+{
+    thread_local MultiplyProgress progress = {nullptr, 0, 0};
+    return progress;
+}
+
+/**
+ * @brief Counts finished work units. Every 256 units, and at the end, the progress is reported and
+ * the token is checked, which is the safe point where a cancelled multiplication throws.
+ * 统计完成的工作单元。每256个单元以及结束时报告进度并检查令牌，这是已取消的乘法抛出异常的安全点。
+ *
+ * @param units Number of units just finished. 刚完成的单元数。
+ */
+static void multiplyCheckpoint(uint64_t units)
+{
+    MultiplyProgress &progress = threadProgress();
+    if (progress.token == nullptr)
     {
-        this->sign = true;
-        rend--;
+        return;
     }
-    else
+    uint64_t before = progress.done;
+    progress.done += units;
+    if (before / 256 != progress.done / 256 || progress.done >= progress.total)
     {
-        this->sign = true;
+        progress.token->setProgress(min(1.0, static_cast<double>(progress.done) / progress.total));
+        progress.token->check();
     }
-    // Reverse traverse and store in little-endian
-    // 反向遍历，并小端存储
-    for (auto it = value.rbegin(); it != rend; ++it)
+}
+
+/**
+ * @brief Schoolbook convolution, out[i + j] += a[i] * b[j] without carrying. out must hold n + m - 1 zeroed coefficients.
+ * 手算卷积，out[i + j] += a[i] * b[j]，不处理进位。out 必须有 n + m - 1 个初始化为零的系数。
+ *
+ * @param a
+ * @param n Length of a. a 的长度。
+ * @param b
+ * @param m Length of b. b 的长度。
+ * @param out
+ */
+static void convolveSchoolbook(const int64_t *a, size_t n, const int64_t *b, size_t m, int64_t *out)
+{
+    for (size_t i = 0; i < n; ++i)
     {
-        this->digits.push_back(static_cast<uint8_t>(*it - '0'));
+        for (size_t j = 0; j < m; ++j)
+        {
+            out[i + j] += a[i] * b[j];
+        }
     }
 }
 
 /**
- * @brief Copy constructor.
- * 拷贝构造函数。
+ * @brief Scratch space needed by convolveKaratsuba for operands of length n.
+ * convolveKaratsuba 处理长度为 n 的操作数所需的临时空间。
  *
- * @param other The object to copy. 要拷贝的对象。
+ * @param n
+ * @param threshold
+ * @return size_t
  */
-BigInt::BigInt(const BigInt &other)
+static size_t karatsubaScratchSize(size_t n, size_t threshold)
 {
-    // Creating a new object
-    // 创建新对象
-    BigInt newBigInt = BigInt();
-    // Assignment
-    // 赋值
-    this->digits = other.getDigits();
-    this->sign = other.getSign();
+    if (n < threshold)
+    {
+        return 0;
+    }
+    size_t high = n - n / 2;
+    return 4 * high + karatsubaScratchSize(high, threshold);
 }
 
 /**
- * @brief Overloaded assignment operator (String).
- * 重载赋值运算符（String）。
+ * @brief Number of schoolbook leaves convolveKaratsuba runs for operands of length n. The two halves
+ * of a length differ by at most one, so each level has at most two distinct lengths and the count
+ * is memoized per length.
+ * convolveKaratsuba 处理长度为 n 的操作数时执行的手算叶子数。同一长度的两半最多相差一，
+ * 因此每层最多有两种不同的长度，按长度记忆计数。
  *
- * @param other The string to assign from.赋值来源的string。
- * @return BigInt&
+ * @param n
+ * @param threshold
+ * @return uint64_t
  */
-BigInt &BigInt::operator=(const string &value)
+static uint64_t karatsubaLeafCount(size_t n, size_t threshold)
 {
-    this->digits.clear();
-    auto rend = value.rend();
-    // Check the sign of the input number (string), start from index 1 to ignore the sign if it exists
-    // 检测输入数字（字符串）的符号，如果有符号就从下标1开始来忽略符号
-    if (value[0] == '-')
+    thread_local vector<pair<size_t, uint64_t>> memo;
+    thread_local size_t memoThreshold = 0;
+    if (n < threshold)
     {
-        this->sign = false;
-        rend--;
+        return 1;
     }
-    else if (value[0] == '+')
+    if (memoThreshold != threshold)
     {
-        this->sign = true;
-        rend--;
+        memo.clear();
+        memoThreshold = threshold;
     }
-    else
+    for (const pair<size_t, uint64_t> &entry : memo)
     {
-        this->sign = true;
+        if (entry.first == n)
+        {
+            return entry.second;
+        }
     }
-    // Reverse traverse and store in little-endian
-    // 反向遍历，并小端存储
-    for (auto it = value.rbegin(); it != rend; ++it)
+    size_t low = n / 2;
+    uint64_t count = karatsubaLeafCount(low, threshold) + 2 * karatsubaLeafCount(n - low, threshold);
+    if (memo.size() >= 256)
     {
-        this->digits.push_back(static_cast<uint8_t>(*it - '0'));
+        memo.clear();
     }
-    return *this;
+    memo.emplace_back(n, count);
+    return count;
 }
 
 /**
- * @brief Overloaded assignment operator (int64_t).
- * 重载赋值运算符（int64_t）。
+ * @brief Karatsuba convolution of two operands of length n, without carrying. out receives 2n - 1 coefficients.
+ * 两个长度为 n 的操作数的 Karatsuba 卷积，不处理进位。out 接收 2n - 1 个系数。
  *
- * @param other
- * @return BigInt&
+ * @param a
+ * @param b
+ * @param n Length of a and b. a 和 b 的长度。
+ * @param out
+ * @param scratch At least karatsubaScratchSize(n, threshold) coefficients. 至少 karatsubaScratchSize(n, threshold) 个系数。
+ * @param threshold Length below which schoolbook convolution is used. 低于该长度时使用手算卷积。
  */
-BigInt &BigInt::operator=(int64_t value)
+static void convolveKaratsuba(const int64_t *a, const int64_t *b, size_t n, int64_t *out, int64_t *scratch, size_t threshold)
 {
-    this->digits.clear();
-    // Initialize sign
-    // 初始化符号
-    if (value >= 0)
+    if (n < threshold)
     {
-        this->sign = true;
+        fill(out, out + 2 * n - 1, 0);
+        convolveSchoolbook(a, n, b, n, out);
+        multiplyCheckpoint(1);
+        return;
     }
-    else
+    // Split into a = a1 * 10^low + a0 and b = b1 * 10^low + b0
+    // 拆分为 a = a1 * 10^low + a0 和 b = b1 * 10^low + b0
+    size_t low = n / 2;
+    size_t high = n - low;
+    // z0 = a0 * b0 goes to out[0, 2 * low - 1), z2 = a1 * b1 goes to out[2 * low, 2 * n - 1)
+    // z0 = a0 * b0 存入 out[0, 2 * low - 1)，z2 = a1 * b1 存入 out[2 * low, 2 * n - 1)
+    int64_t *sumA = scratch;
+    int64_t *sumB = scratch + high;
+    int64_t *z1 = scratch + 2 * high;
+    int64_t *next = scratch + 4 * high;
+    convolveKaratsuba(a, b, low, out, next, threshold);
+    out[2 * low - 1] = 0;
+    convolveKaratsuba(a + low, b + low, high, out + 2 * low, next, threshold);
+    // z1 = (a0 + a1) * (b0 + b1) - z0 - z2
+    // z1 = (a0 + a1) * (b0 + b1) - z0 - z2
+    for (size_t i = 0; i < high; ++i)
     {
-        this->sign = false;
-        value = -value;
+        sumA[i] = a[low + i] + (i < low ? a[i] : 0);
+        sumB[i] = b[low + i] + (i < low ? b[i] : 0);
     }
-    // Little-endian storage
-    // 小端存储
-    // If the input value is 0, then assign directly
-    // 如果传入值为0则直接赋值
-    if (value == 0)
+    convolveKaratsuba(sumA, sumB, high, z1, next, threshold);
+    for (size_t i = 0; i + 1 < 2 * low; ++i)
     {
-        this->digits.push_back(0);
+        z1[i] -= out[i];
     }
-    // Otherwise, split the input value and store
-    // 否则拆分传入值并储存
-    else
+    for (size_t i = 0; i + 1 < 2 * high; ++i)
     {
-        while (value != 0)
-        {
-            this->digits.push_back(static_cast<uint8_t>(value % 10));
-            value /= 10;
-        }
+        z1[i] -= out[2 * low + i];
+    }
+    // Add z1 * 10^low
+    // 加上 z1 * 10^low
+    for (size_t i = 0; i + 1 < 2 * high; ++i)
+    {
+        out[low + i] += z1[i];
     }
-    return *this;
 }
 
 /**
- * @brief Overloaded assignment operator (BigInt).
- * 重载赋值运算符（BigInt）。
+ * @brief Convolution of the absolute values of two digit sequences without carrying, for operands past
+ * the schoolbook tier. Balanced operands use Karatsuba and the sink gets all coefficients at once. When
+ * one operand is at least twice as long as the other, it is multiplied slice by slice and the sink gets
+ * the coefficients of each slice at its offset, so the buffers stay below 4 * min(n, m) coefficients
+ * whatever the length of the longer operand. Neighbouring slices overlap, so the sink must add the
+ * coefficients, not store them. The coefficients are only valid during the call of the sink.
+ * 两个数字序列绝对值的卷积，不处理进位，用于超出手算乘法层的操作数。长度相近的操作数使用 Karatsuba，
+ * sink 一次得到全部系数。一个操作数的长度至少是另一个的两倍时，逐片相乘，sink 在每片的偏移处得到该片的系数，
+ * 因此无论较长操作数有多长，缓冲区都小于 4 * min(n, m) 个系数。相邻的片有重叠，所以 sink 必须累加系数而不是存储。
+ * 系数只在调用 sink 期间有效。
  *
- * @param other
- * @return BigInt&
+ * @param a
+ * @param b
+ * @param threshold Karatsuba threshold. Karatsuba 阈值。
+ * @param sink Called with (offset, coefficients, count). 以 (偏移, 系数, 个数) 调用。
  */
-BigInt &BigInt::operator=(const BigInt &other)
+static void convolveDigits(const DigitVector &a, const DigitVector &b, size_t threshold, const function<void(size_t, const int64_t *, size_t)> &sink)
 {
-    if (this == &other)
+    MultiplyProgress &progress = threadProgress();
+    // Buffers are kept between calls to avoid reallocating them
+    // 缓冲区在调用之间保留，以避免重复分配
+    thread_local vector<int64_t> wideA, wideB, product, scratch;
+    const DigitVector &longer = a.size() >= b.size() ? a : b;
+    const DigitVector &shorter = a.size() >= b.size() ? b : a;
+    size_t n = longer.size();
+    size_t m = shorter.size();
+
+    // Karatsuba tier, the shorter operand is padded with zeros to the length of the longer one
+    // Karatsuba 层，较短的操作数用零补齐到较长操作数的长度
+    if (n < 2 * m)
     {
-        return *this;
+        wideA.assign(n, 0);
+        wideB.assign(n, 0);
+        copy(longer.begin(), longer.end(), wideA.begin());
+        copy(shorter.begin(), shorter.end(), wideB.begin());
+        product.resize(2 * n - 1);
+        scratch.resize(karatsubaScratchSize(n, threshold));
+        progress.total = progress.token != nullptr ? karatsubaLeafCount(n, threshold) : 0;
+        convolveKaratsuba(wideA.data(), wideB.data(), n, product.data(), scratch.data(), threshold);
+        sink(0, product.data(), n + m - 1);
+        return;
+    }
+    // Unbalanced tier: the longer operand is cut into slices of m digits, each slice is multiplied
+    // by the shorter operand with balanced Karatsuba and handed to the sink at its offset. The shorter
+    // operand is widened once, and the padding is at most one slice instead of n - m digits.
+    // 不平衡层：将较长的操作数切成 m 位的片，每片与较短的操作数做平衡的 Karatsuba 乘法并在对应的偏移处交给 sink。
+    // 较短的操作数只扩展一次，补零最多一片，而不是 n - m 位。
+    // Its Karatsuba half-sums are recomputed for every slice. They are linear passes next to the
+    // leaf products, and keeping them for every level would take about 1.5 * m * (m / threshold)^0.585
+    // coefficients, so they are not cached.
+    // 它的 Karatsuba 半和在每一片中重新计算。与叶子乘积相比它们只是线性遍历，而为每一层保存它们
+    // 需要约 1.5 * m * (m / threshold)^0.585 个系数，所以不缓存。
+    wideB.assign(shorter.begin(), shorter.end());
+    wideA.resize(m);
+    // The product of one slice is followed by the Karatsuba scratch space
+    // 一片的乘积之后是 Karatsuba 的临时空间
+    vector<int64_t> &slice = scratch;
+    size_t scratchSize = karatsubaScratchSize(m, threshold);
+    scratch.resize(2 * m - 1 + scratchSize);
+    int64_t *sliceScratch = scratch.data() + 2 * m - 1;
+    progress.total = progress.token != nullptr ? (n + m - 1) / m * karatsubaLeafCount(m, threshold) : 0;
+    for (size_t offset = 0; offset < n; offset += m)
+    {
+        size_t length = min(m, n - offset);
+        copy(longer.begin() + offset, longer.begin() + offset + length, wideA.begin());
+        fill(wideA.begin() + length, wideA.end(), 0);
+        convolveKaratsuba(wideA.data(), wideB.data(), m, slice.data(), sliceScratch, threshold);
+        sink(offset, slice.data(), length + m - 1);
     }
-    this->digits = other.getDigits();
-    this->sign = other.getSign();
-    return *this;
 }
 
 /**
- * @brief += operation.
- * += 运算符。
+ * @brief Splits a signed column value into a digit and a carry rounded towards negative infinity,
+ * so that the digit stays in [0, 9] when products are subtracted.
+ * 将有符号的列值拆分为一位数字和向负无穷取整的进位，使减去乘积时数字仍在 [0, 9] 内。
  *
- * @param rhs Right-hand side. 右侧操作数。
- * @return BigInt&
+ * @param current Column value. 列值。
+ * @param digit Receives the digit. 接收数字。
+ * @return int64_t Carry. 进位。
  */
-BigInt &BigInt::operator+=(const BigInt &rhs)
+static inline int64_t splitColumn(int64_t current, uint8_t &digit)
 {
-    // Addition with different signs
-    // 异号相加
-    if (this->sign != rhs.sign)
+    int64_t carry = (current >= 0 ? current : current - 9) / 10;
+    digit = static_cast<uint8_t>(current - carry * 10);
+    return carry;
+}
+
+/**
+ * @brief Adds direction * columns[i] to digits[offset + i] with signed carries, then carries on past them
+ * until the carry is 0 or the digits end.
+ * 以有符号进位将 direction * columns[i] 加到 digits[offset + i] 上，之后继续进位，直到进位为0或数字结束。
+ *
+ * @param digits
+ * @param offset Position of the first column. 第一列的位置。
+ * @param columns
+ * @param count Number of columns, offset + count must not exceed the digits. 列数，offset + count 不能超过数字的长度。
+ * @param direction 1 to add, -1 to subtract. 1 表示加，-1 表示减。
+ * @return int64_t Carry out of the top digit. 从最高位溢出的进位。
+ */
+static int64_t addColumns(DigitVector &digits, size_t offset, const int64_t *columns, size_t count, int64_t direction)
+{
+    int64_t carry = 0;
+    size_t k = offset;
+    for (size_t i = 0; i < count; ++i, ++k)
     {
-        // lhs's absolute value is greater than or equal to rhs's
-        // lhs 的绝对值大于等于 rhs 的绝对值
-        if (isAbsGreaterOrEqual(*this, rhs))
-        {
-            subtractAbs(rhs);
-        }
-        // lhs's absolute value is less than rhs's
-        // lhs 的绝对值小于 rhs 的绝对值
-        else
+        carry = splitColumn(digits[k] + direction * columns[i] + carry, digits[k]);
+    }
+    for (; carry != 0 && k < digits.size(); ++k)
+    {
+        carry = splitColumn(digits[k] + carry, digits[k]);
+    }
+    return carry;
+}
+
+/**
+ * @brief Multiplies the absolute values of two digit sequences into out (n + m digits, may have leading zeros).
+ * Short operands use schoolbook multiplication, longer ones Karatsuba, as chosen by the tuning profile.
+ * When one operand is at least twice as long as the other, it is multiplied slice by slice.
+ * Under a BigIntCancelScope, progress is reported and the token is checked as the work proceeds.
+ * out must not be a or b.
+ * 将两个数字序列的绝对值相乘，结果存入 out（n + m 位，可能有前导零）。
+ * 根据调优配置，较短的操作数使用手算乘法，较长的使用 Karatsuba 乘法。
+ * 一个操作数的长度至少是另一个的两倍时，逐片相乘。
+ * 在 BigIntCancelScope 中，运算过程中会报告进度并检查令牌。
+ * out 不能是 a 或 b。
+ *
+ * @param a
+ * @param b
+ * @param out
+ */
+static void multiplyDigits(const DigitVector &a, const DigitVector &b, DigitVector &out)
+{
+    size_t threshold = max<size_t>(BigInt::getTuning().karatsubaThreshold, 2);
+    out.assign(a.size() + b.size(), 0);
+    // Progress is only tracked under a cancellation token
+    // 只有在取消令牌下才跟踪进度
+    MultiplyProgress &progress = threadProgress();
+    progress.token = BigIntCancelScope::current();
+    progress.done = 0;
+
+    // Schoolbook tier
+    // 手算乘法层
+    if (min(a.size(), b.size()) < threshold)
+    {
+        progress.total = a.size();
+        for (size_t i = 0; i < a.size(); ++i)
         {
-            // Create a copy of rhs
-            // 创建 rhs 的副本
-            BigInt temp = rhs; 
-            temp.subtractAbs(*this);
-            *this = std::move(temp);
-            // The result has the same sign with rhs
-            // 结果的符号与 rhs 相同
-            this->sign = rhs.sign;
+            multiplyCheckpoint(1);
+            int carry = 0;
+            for (size_t j = 0; j < b.size() || carry; ++j)
+            {
+                int current = out[i + j] + a[i] * (j < b.size() ? b[j] : 0) + carry;
+                carry = current / 10;
+                out[i + j] = current % 10;
+            }
         }
+        return;
     }
-    // Addition with the same sign
-    // 同号相加
-    else
-    {
-        // Handling the same sign, whether both are positive or negative
-        // 处理同号情况，无论是两个正数还是两个负数
-        size_t maxLength = std::max(this->digits.size(), rhs.digits.size());
-        // Carry
-        // 进位标识
-        bool carry = false;
-        for (size_t i = 0; i < maxLength || carry; ++i)
+
+    // Carry each part of the convolution into out as soon as it is computed
+    // 卷积的每一部分算出后立即进位到 out 中
+    convolveDigits(a, b, threshold, [&out](size_t offset, const int64_t *columns, size_t count)
+                   { addColumns(out, offset, columns, count, 1); });
+}
+
+/**
+ * @brief The fused kernel of addmul and submul: adds |a| * |b| to, or subtracts it from, the digits of acc
+ * in place. In the schoolbook tier each row of partial products goes straight into acc. In the other tiers
+ * the coefficients of each Karatsuba product are carried into acc as they come: all of them for balanced
+ * operands, one slice at a time for unbalanced ones, so the coefficient buffer is bounded by the shorter
+ * operand (below 4 * min(n, m)) and no product digits are stored. When a subtraction goes below zero, a
+ * borrow is left past the top digit and acc holds the ten's complement of the result, which is then
+ * negated in one more pass.
+ * addmul 和 submul 的融合内核：将 |a| * |b| 原地加到 acc 的数字上或从中减去。手算乘法层中每一行部分积直接
+ * 累加到 acc。其他层中每个 Karatsuba 乘积的系数一算出就进位到 acc：长度相近的操作数一次全部，不平衡的操作数
+ * 每次一片，因此系数缓冲区受较短操作数限制（小于 4 * min(n, m)），且不存储乘积的数字。
+ * 减法结果小于零时，最高位之外会留下一个借位，acc 中是结果的十进制补码，再用一次遍历取负。
+ *
+ * @param a
+ * @param b
+ * @param acc Digits of the accumulator, must not be a or b, may have leading zeros afterwards. 累加器的数字，不能是 a 或 b，之后可能有前导零。
+ * @param subtract true to subtract the product. true 表示减去乘积。
+ * @return true The result is negative and acc holds its absolute value. 结果为负，acc 中是其绝对值。
+ * @return false The result is not negative. 结果非负。
+ */
+static bool accumulateProduct(const DigitVector &a, const DigitVector &b, DigitVector &acc, bool subtract)
+{
+    size_t threshold = max<size_t>(BigInt::getTuning().karatsubaThreshold, 2);
+    // One more digit than the longer of acc and the product, so that a sum cannot carry out of acc
+    // 比 acc 与乘积中较长者多一位，使和不会从 acc 中进位溢出
+    size_t length = max(acc.size(), a.size() + b.size()) + 1;
+    acc.resize(length, 0);
+    int64_t direction = subtract ? -1 : 1;
+    // Carry out of the top digit, 0 or -1 once the whole product is accumulated
+    // 从最高位溢出的进位，整个乘积累加完后为0或-1
+    int64_t overflow = 0;
+    MultiplyProgress &progress = threadProgress();
+    progress.token = BigIntCancelScope::current();
+    progress.done = 0;
+
+    if (min(a.size(), b.size()) < threshold)
+    {
+        progress.total = a.size();
+        for (size_t i = 0; i < a.size(); ++i)
         {
-            // If lhs (left-hand operand, i.e., this) is the shorter one, append a digit to lhs
-            // 如果lhs（左侧加数，即this）是长度较短的那个数，则每次给lhs补一位
-            if (i == this->digits.size())
+            multiplyCheckpoint(1);
+            if (a[i] == 0)
             {
-                this->digits.push_back(0);
+                continue;
             }
-            // The ternary operator: if the current index is within the bounds of rhs digits, then add the corresponding digit of lhs to rhs, otherwise add 0
-            // 三则表达式：如果当前下标对于右侧加数没有下标越界，即右侧加数还没加完所有位时，则当前左侧加数对应位加右侧加数对应位，否则左侧加数对应位加0
-            // Add the corresponding digit of lhs and rhs, plus 1 if there's a carry (true=1)
-            // 左侧加数对应位与右侧加数对应位相加，有进位时额外+1（true=1）
-            this->digits[i] += carry + (i < rhs.digits.size() ? rhs.digits[i] : 0);
-            // Handling carry
-            // 处理进位
-            carry = (this->digits[i] >= 10);
-            if (carry)
+            int64_t row = direction * a[i];
+            int64_t carry = 0;
+            size_t k = i;
+            for (size_t j = 0; j < b.size(); ++j, ++k)
+            {
+                carry = splitColumn(acc[k] + row * b[j] + carry, acc[k]);
+            }
+            for (; carry != 0 && k < length; ++k)
             {
-                this->digits[i] -= 10;
+                carry = splitColumn(acc[k] + carry, acc[k]);
             }
+            overflow += carry;
         }
     }
-    // Remove leading zeros (mainly used for leading zeros generated by subtraction)
-    // 删除前导零（主要用于减法时产生的前导零）
-    while (this->digits.size() > 1 && this->digits.back() == 0)
+    else
     {
-        this->digits.pop_back();
+        // Like the rows above, each Karatsuba product (one slice of an unbalanced product) is carried into acc
+        // as soon as it is computed
+        // 与上面的行一样，每个 Karatsuba 乘积（不平衡乘积中的一片）算出后立即进位到 acc 中
+        convolveDigits(a, b, threshold, [&](size_t offset, const int64_t *columns, size_t count)
+                       { overflow += addColumns(acc, offset, columns, count, direction); });
     }
-    // If the final result is 0, forcefully set the sign to positive
-    // 如果最终结果为0，把符号强制设置为+
-    if ((this->digits.size() == 1) && (this->digits[0] == 0))
+
+    if (overflow == 0)
     {
-        this->sign = true;
+        return false;
     }
-    return *this;
+    // acc holds 10^length + result, negate it: 10^length - acc
+    // acc 中是 10^length + result，对其取负：10^length - acc
+    int borrow = 0;
+    for (size_t k = 0; k < length; ++k)
+    {
+        int current = -acc[k] - borrow;
+        borrow = current < 0;
+        acc[k] = static_cast<uint8_t>(current + 10 * borrow);
+    }
+    return true;
 }
 
 /**
- * @brief -= operator, implemented as the inverse operation of +=.
- * -= 运算符，作为 += 的逆运算实现。
- *
- * @param rhs
- * @return BigInt&
+ * @brief Default constructor. Value is automatically set to zero, and sign is automatically positive.
+ * 默认构造函数。值自动设为零，符号自动设为正。
  */
-BigInt &BigInt::operator-=(const BigInt &rhs)
+BigInt::BigInt()
 {
-    return *this += -rhs;
+    this->digits.clear();
+    this->digits.push_back(0);
+    this->sign = true;
 }
 
 /**
- * @brief *= operator, implemented by simulating manual multiplication.
- * *= 运算符，模拟手算乘法实现。
+ * @brief Initializes with a signed 64-bit integer.
+ * 使用signed 64-bit integer进行初始化。
  *
- * @param rhs
- * @return BigInt&
+ * @param value The signed 64-bit integer to initialize with.传入的signed 64-bit integer。
  */
-BigInt &BigInt::operator*=(const BigInt &rhs)
+BigInt::BigInt(int64_t value)
 {
-    // Create a new BigInt object as the result of multiplication
-    // 创建一个新的 BigInt 对象作为乘法结果
-    BigInt result;
-    result.digits.resize(this->digits.size() + rhs.digits.size(), 0);
-
-    // Perform multiplication operation
-    // 执行乘法运算
-    for (size_t i = 0; i < this->digits.size(); ++i)
+    this->digits.clear();
+    // Initialize sign
+    // 初始化符号
+    if (value >= 0)
     {
-        int carry = 0;
-        for (size_t j = 0; j < rhs.digits.size() || carry; ++j)
-        {
-            int current = result.digits[i + j] + this->digits[i] * (j < rhs.digits.size() ? rhs.digits[j] : 0) + carry;
-            carry = current / 10;
-            result.digits[i + j] = current % 10;
-        }
+        this->sign = true;
     }
-
-    // Remove leading zeros from the result
-    // 删除结果中的前导零
-    while (result.digits.size() > 1 && result.digits.back() == 0)
+    else
     {
-        result.digits.pop_back();
+        this->sign = false;
+        value = -value;
     }
-
-    // Handle the sign
-    // 处理符号
-    // The sign is positive by default when the result is 0
-    // 结果为0时默认符号为正
-    if (result.digits.size() == 1 && result.digits[0] == 0)
+    // Little-endian storage
+    // 小端存储
+    // If the input value is 0, then assign directly
+    // 如果传入值为0则直接赋值
+    if (value == 0)
     {
-        result.sign = true;
+        this->sign = true;
+        this->digits.push_back(0);
     }
+    // Otherwise, split the input value and store
+    // 否则拆分传入值并储存
     else
     {
-        result.sign = !(this->sign ^ rhs.sign);
+        while (value != 0)
+        {
+            this->digits.push_back(static_cast<uint8_t>(value % 10));
+            value /= 10;
+        }
     }
-
-    // Update the current object
-    // 更新当前对象
-    *this = std::move(result);
-    return *this;
 }
 
 /**
- * @brief Negation operator.
- * 负号运算符。
+ * @brief Smallest number of digits given to one thread by the parallel conversions.
+ * 并行转换分配给每个线程的最少位数。
+ */
+static const size_t MIN_DIGITS_PER_THREAD = 1 << 16;
+
+/**
+ * @brief Number of threads a conversion of length digits is split across, following the tuning.
+ * 按调优参数确定 length 位的转换拆分到的线程数。
  *
- * @return BigInt
+ * @param length Number of digits. 位数。
+ * @return size_t 1 when the conversion stays on the calling thread. 为1时在调用线程上完成转换。
  */
-BigInt BigInt::operator-() const
+static size_t conversionThreadCount(size_t length)
 {
-    // Do nothing if it's 0
-    // 如果为0则不做操作
-    if (this->digits.size() == 1 && this->digits[0] == 0)
-    {
-        return *this;
-    }
-    // Otherwise, negate the sign
-    // 否则符号取负
-    else
+    const BigIntTuning &tuning = BigInt::getTuning();
+    if (length < tuning.parallelConversionThreshold)
     {
-        BigInt result = BigInt(*this);
-        result.sign = !this->sign;
-        return result;
+        return 1;
     }
+    size_t threads = tuning.conversionThreads != 0 ? tuning.conversionThreads : thread::hardware_concurrency();
+    return max<size_t>(1, min(threads, length / MIN_DIGITS_PER_THREAD));
 }
 
 /**
- * @brief == operator.
- * == 运算符。
+ * @brief Runs body over [0, length), split into contiguous ranges across threads for long conversions.
+ * 在 [0, length) 上执行 body，长转换拆分为连续区间分配到多个线程。
  *
- * @param rhs Right-hand side右侧操作数 
- * @return true
- * @return false
+ * @param length Number of digits. 位数。
+ * @param body Called with [begin, end). 以 [begin, end) 调用。
  */
-bool BigInt::operator==(const BigInt &rhs) const
+static void forEachDigitRange(size_t length, const function<void(size_t, size_t)> &body)
 {
-    if (this->sign != rhs.sign)
+    size_t threadCount = conversionThreadCount(length);
+    if (threadCount <= 1)
     {
-        return false;
+        body(0, length);
+        return;
     }
-    else if (this->digits == rhs.digits)
+    vector<thread> threads;
+    size_t chunk = (length + threadCount - 1) / threadCount;
+    for (size_t begin = 0; begin < length; begin += chunk)
     {
-        return true;
+        threads.emplace_back(body, begin, min(length, begin + chunk));
     }
-    else
+    for (thread &worker : threads)
     {
-        return false;
+        worker.join();
     }
 }
 
 /**
- * @brief != operator.
- * != 运算符。
+ * @brief Initializes from a string.
+ * 从string初始化。
  *
- * @param rhs Right-hand side右侧操作数 
- * @return true
- * @return false
+ * @param value The string to initialize from. 传入的string。
  */
-bool BigInt::operator!=(const BigInt &rhs) const
+BigInt::BigInt(const string &value)
 {
-    return !(*this == rhs);
+    this->assignDecimal(value);
 }
 
 /**
- * @brief < operator.
- * < 运算符。
+ * @brief Stores the digits of a decimal string with an optional sign. Long strings are
+ * converted in parallel ranges, each thread writing its own part of the digits.
+ * 存储可以带符号的十进制字符串的数字。长字符串按区间并行转换，每个线程写入各自的一段数字。
  *
- * @param rhs Right-hand side右侧操作数
- * @return true
- * @return false
+ * @param value The string to initialize from. 传入的string。
  */
-bool BigInt::operator<(const BigInt &rhs) const
+void BigInt::assignDecimal(const string &value)
 {
-    // If the signs are different
-    // 如果两数异号
-    if (this->sign != rhs.sign)
+    // Check the sign of the input number (string), start from index 1 to ignore the sign if it exists
+    // 检测输入数字（字符串）的符号，如果有符号就从下标1开始来忽略符号
+    size_t start = 0;
+    this->sign = true;
+    if (!value.empty() && (value[0] == '-' || value[0] == '+'))
     {
-        if (this->sign)
-        {
-            return false;
-        }
-        else
-        {
-            return true;
-        }
+        this->sign = (value[0] != '-');
+        start = 1;
     }
-    // If the signs are the same
-    // 如果两数同号
-    else
-    {
-        // For positive numbers or 0
-        // 两数为正数或0
-        if (this->sign)
-        {
-            // Compare the number of digits first, the number with more digits is definitely larger
-            // 先比较位数，位数大的数必然更大
-            if (this->size() > rhs.size())
-            {
-                return false;
-            }
-            else if ((this->size()) < rhs.size())
-            {
-                return true;
-            }
-            // If the number of digits is the same, compare digit by digit
-            // 位数相同则一位一位比较
-            else
-            {
-                // Use iterators for traversal
-                // 使用迭代器进行遍历
-                auto itRhs = rhs.digits.rbegin();
-                for (auto it = this->digits.rbegin(); it != this->digits.rend(); it++)
-                {
-                    if (*it == *itRhs)
-                    {
-                        itRhs++;
-                        continue;
-                    }
-                    else if (*it < *itRhs)
-                    {
-                        return true;
-                    }
-                    else
-                    {
-                        return false;
-                    }
-                }
-                // Reaching here means the two numbers are equal, so return false
-                // 能走到这一步证明两数相等，所以return false
-                return false;
-            }
-        }
-        // For negative numbers
-        else
+    size_t length = value.size() - start;
+    DigitVector &digits = this->digits.overwrite();
+    digits.resize(length);
+    // Reverse traverse and store in little-endian
+    // 反向遍历，并小端存储
+    const char *text = value.data() + start;
+    uint8_t *out = digits.data();
+    forEachDigitRange(length, [text, out, length](size_t begin, size_t end)
+                      {
+        for (size_t i = begin; i < end; ++i)
         {
-            // Compare the number of digits first, the number with more digits is actually smaller
-            // 先比较位数，位数大的数必然更小
-            if (this->size() > rhs.size())
-            {
-                return true;
-            }
-            else if ((this->size()) < rhs.size())
-            {
-                return false;
-            }
-            // If the number of digits is the same, compare digit by digit
-            // 位数相同则一位一位比较
-            else
-            {
-                // Use iterators for traversal
-                // 使用迭代器进行遍历
-                auto itRhs = rhs.digits.rbegin();
-                for (auto it = this->digits.rbegin(); it != this->digits.rend(); it++)
-                {
-                    if (*it == *itRhs)
-                    {
-                        itRhs++;
-                        continue;
-                    }
-                    if (*it < *itRhs)
-                    {
-                        return false;
-                    }
-                    else
-                    {
-                        return true;
-                    }
-                }
-                // Reaching here means the two numbers are equal, so return false
-                // 能走到这一步证明两数相等，所以return false
-                return false;
-            }
-        }
-    }
+            out[i] = static_cast<uint8_t>(text[length - 1 - i] - '0');
+        } });
 }
 
 /**
- * @brief > operator.
- * > 运算符。
+ * @brief Copy constructor.
+ * 拷贝构造函数。
  *
- * @param rhs
- * @return true
- * @return false
+ * @param other The object to copy. 要拷贝的对象。
  */
-bool BigInt::operator>(const BigInt &rhs) const
+BigInt::BigInt(const BigInt &other)
+    : sign(other.sign), digits(other.digits)
 {
-    // If the signs are different
-    // 如果两数异号
+}
+
+/**
+ * @brief Move constructor, takes over the digits of other without copying them.
+ * 移动构造函数，直接接管 other 的数字而不拷贝。
+ *
+ * @param other The object to move from. 被移动的对象。
+ */
+BigInt::BigInt(BigInt &&other) noexcept
+    : sign(other.sign), digits(std::move(other.digits))
+{
+}
+
+/**
+ * @brief Overloaded assignment operator (String).
+ * 重载赋值运算符（String）。
+ *
+ * @param other The string to assign from.赋值来源的string。
+ * @return BigInt&
+ */
+BigInt &BigInt::operator=(const string &value)
+{
+    this->assignDecimal(value);
+    return *this;
+}
+
+/**
+ * @brief Overloaded assignment operator (int64_t).
+ * 重载赋值运算符（int64_t）。
+ *
+ * @param other
+ * @return BigInt&
+ */
+BigInt &BigInt::operator=(int64_t value)
+{
+    this->digits.clear();
+    // Initialize sign
+    // 初始化符号
+    if (value >= 0)
+    {
+        this->sign = true;
+    }
+    else
+    {
+        this->sign = false;
+        value = -value;
+    }
+    // Little-endian storage
+    // 小端存储
+    // If the input value is 0, then assign directly
+    // 如果传入值为0则直接赋值
+    if (value == 0)
+    {
+        this->digits.push_back(0);
+    }
+    // Otherwise, split the input value and store
+    // 否则拆分传入值并储存
+    else
+    {
+        while (value != 0)
+        {
+            this->digits.push_back(static_cast<uint8_t>(value % 10));
+            value /= 10;
+        }
+    }
+    return *this;
+}
+
+/**
+ * @brief Overloaded assignment operator (BigInt).
+ * 重载赋值运算符（BigInt）。
+ *
+ * @param other
+ * @return BigInt&
+ */
+BigInt &BigInt::operator=(const BigInt &other)
+{
+    if (this == &other)
+    {
+        return *this;
+    }
+    // Copy-assigning the vector reuses the existing capacity
+    // 拷贝赋值 vector 会复用已有的容量
+    this->digits = other.digits;
+    this->sign = other.sign;
+    return *this;
+}
+
+/**
+ * @brief Move assignment operator (BigInt).
+ * 移动赋值运算符（BigInt）。
+ *
+ * @param other
+ * @return BigInt&
+ */
+BigInt &BigInt::operator=(BigInt &&other) noexcept
+{
+    this->digits.swap(other.digits);
+    this->sign = other.sign;
+    return *this;
+}
+
+/**
+ * @brief Makes room for the longest possible result of an in-place operation before its digit loop.
+ * A buffer that is too small grows once, by growthPercent percent of the needed length on top instead of
+ * the doubling of vector, so values that gain a digit now and then keep little spare capacity.
+ * 在原地运算的逐位循环之前，为其最长可能的结果预留空间。
+ * 缓冲区不够时只增长一次，在所需长度之上额外预留 growthPercent 百分比，而不是 vector 的加倍，
+ * 使偶尔增加一位的值只保留很少的空闲容量。
+ *
+ * @param digits
+ * @param length Longest possible result. 最长可能的结果长度。
+ */
+static void reserveDigits(DigitVector &digits, size_t length)
+{
+    if (digits.capacity() < length)
+    {
+        digits.reserve(length + length * BigInt::getTuning().growthPercent / 100);
+    }
+}
+
+/**
+ * @brief += operation.
+ * += 运算符。
+ *
+ * @param rhs Right-hand side. 右侧操作数。
+ * @return BigInt&
+ */
+BigInt &BigInt::operator+=(const BigInt &rhs)
+{
+    addSigned(rhs, rhs.sign);
+    return *this;
+}
+
+/**
+ * @brief Adds rhs with the given sign instead of its own, so that -= does not need a negated copy of rhs.
+ * rhs may be this object.
+ * 以给定的符号（而不是 rhs 自身的符号）加上 rhs，这样 -= 不需要构造 rhs 的相反数副本。
+ * rhs 可以是当前对象本身。
+ *
+ * @param rhs Right-hand side. 右侧操作数。
+ * @param rhsSign Sign used for rhs. rhs 使用的符号。
+ */
+void BigInt::addSigned(const BigInt &rhs, bool rhsSign)
+{
+    // Addition with different signs
+    // 异号相加
+    if (this->sign != rhsSign)
+    {
+        // lhs's absolute value is greater than or equal to rhs's
+        // lhs 的绝对值大于等于 rhs 的绝对值
+        if (isAbsGreaterOrEqual(*this, rhs))
+        {
+            subtractAbs(rhs);
+        }
+        // lhs's absolute value is less than rhs's
+        // lhs 的绝对值小于 rhs 的绝对值
+        else
+        {
+            // Subtract in place instead of working on a copy of rhs
+            // 原地相减，而不是在 rhs 的副本上计算
+            reverseSubtractAbs(rhs);
+            // The result has the same sign with rhs
+            // 结果的符号与 rhs 相同
+            this->sign = rhsSign;
+        }
+    }
+    // Addition with the same sign
+    // 同号相加
+    else
+    {
+        // Handling the same sign, whether both are positive or negative
+        // 处理同号情况，无论是两个正数还是两个负数
+        size_t maxLength = std::max(this->digits.size(), rhs.digits.size());
+        // Detach once before the loop, rhs is read through its own buffer
+        // 在循环之前分离一次，rhs 通过它自己的缓冲区读取
+        const DigitVector &rhsDigits = rhs.digits;
+        DigitVector &lhsDigits = this->digits.write();
+        // Room for the final carry is made once, rhs stays valid when it is this object
+        // 一次性为最后的进位预留空间，rhs 为当前对象本身时仍然有效
+        reserveDigits(lhsDigits, maxLength + 1);
+        // Carry
+        // 进位标识
+        bool carry = false;
+        for (size_t i = 0; i < maxLength || carry; ++i)
+        {
+            // If lhs (left-hand operand, i.e., this) is the shorter one, append a digit to lhs
+            // 如果lhs（左侧加数，即this）是长度较短的那个数，则每次给lhs补一位
+            if (i == lhsDigits.size())
+            {
+                lhsDigits.push_back(0);
+            }
+            // The ternary operator: if the current index is within the bounds of rhs digits, then add the corresponding digit of lhs to rhs, otherwise add 0
+            // 三则表达式：如果当前下标对于右侧加数没有下标越界，即右侧加数还没加完所有位时，则当前左侧加数对应位加右侧加数对应位，否则左侧加数对应位加0
+            // Add the corresponding digit of lhs and rhs, plus 1 if there's a carry (true=1)
+            // 左侧加数对应位与右侧加数对应位相加，有进位时额外+1（true=1）
+            lhsDigits[i] += carry + (i < rhsDigits.size() ? rhsDigits[i] : 0);
+            // Handling carry
+            // 处理进位
+            carry = (lhsDigits[i] >= 10);
+            if (carry)
+            {
+                lhsDigits[i] -= 10;
+            }
+        }
+    }
+    // Remove leading zeros (mainly used for leading zeros generated by subtraction)
+    // 删除前导零（主要用于减法时产生的前导零）
+    normalize();
+}
+
+/**
+ * @brief -= operator, implemented as the inverse operation of +=.
+ * -= 运算符，作为 += 的逆运算实现。
+ *
+ * @param rhs
+ * @return BigInt&
+ */
+BigInt &BigInt::operator-=(const BigInt &rhs)
+{
+    addSigned(rhs, !rhs.sign);
+    return *this;
+}
+
+/**
+ * @brief *= operator. Simulates manual multiplication for short operands and uses Karatsuba for long ones.
+ * *= 运算符。短操作数模拟手算乘法，长操作数使用 Karatsuba 乘法。
+ *
+ * @param rhs
+ * @return BigInt&
+ */
+BigInt &BigInt::operator*=(const BigInt &rhs)
+{
+    mul(*this, *this, rhs);
+    return *this;
+}
+
+/**
+ * @brief /= operator, truncating towards zero.
+ * /= 运算符，向零截断。
+ *
+ * @param rhs
+ * @return BigInt&
+ */
+BigInt &BigInt::operator/=(const BigInt &rhs)
+{
+    divLong(rhs, false);
+    return *this;
+}
+
+/**
+ * @brief %= operator, the remainder has the sign of the dividend.
+ * %= 运算符，余数与被除数同号。
+ *
+ * @param rhs
+ * @return BigInt&
+ */
+BigInt &BigInt::operator%=(const BigInt &rhs)
+{
+    divLong(rhs, true);
+    return *this;
+}
+
+/**
+ * @brief Negation operator.
+ * 负号运算符。
+ *
+ * @return BigInt
+ */
+BigInt BigInt::operator-() const
+{
+    // Do nothing if it's 0
+    // 如果为0则不做操作
+    if (this->digits.size() == 1 && this->digits[0] == 0)
+    {
+        return *this;
+    }
+    // Otherwise, negate the sign
+    // 否则符号取负
+    else
+    {
+        BigInt result = BigInt(*this);
+        result.sign = !this->sign;
+        return result;
+    }
+}
+
+/**
+ * @brief == operator.
+ * == 运算符。
+ *
+ * @param rhs Right-hand side右侧操作数 
+ * @return true
+ * @return false
+ */
+bool BigInt::operator==(const BigInt &rhs) const
+{
+    // Check the sign and the length first, then compare the digits as one block of memory
+    // 先检查符号和长度，再把数字作为一整块内存比较
+    if (this->sign != rhs.sign || this->digits.size() != rhs.digits.size())
+    {
+        return false;
+    }
+    return memcmp(this->digits.data(), rhs.digits.data(), this->digits.size()) == 0;
+}
+
+/**
+ * @brief != operator.
+ * != 运算符。
+ *
+ * @param rhs Right-hand side右侧操作数 
+ * @return true
+ * @return false
+ */
+bool BigInt::operator!=(const BigInt &rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+ * @brief < operator.
+ * < 运算符。
+ *
+ * @param rhs Right-hand side右侧操作数
+ * @return true
+ * @return false
+ */
+bool BigInt::operator<(const BigInt &rhs) const
+{
+    // If the signs are different
+    // 如果两数异号
+    if (this->sign != rhs.sign)
+    {
+        if (this->sign)
+        {
+            return false;
+        }
+        else
+        {
+            return true;
+        }
+    }
+    // If the signs are the same
+    // 如果两数同号
+    else
+    {
+        // For positive numbers or 0
+        // 两数为正数或0
+        if (this->sign)
+        {
+            // Compare the number of digits first, the number with more digits is definitely larger
+            // 先比较位数，位数大的数必然更大
+            if (this->size() > rhs.size())
+            {
+                return false;
+            }
+            else if ((this->size()) < rhs.size())
+            {
+                return true;
+            }
+            // If the number of digits is the same, compare digit by digit
+            // 位数相同则一位一位比较
+            else
+            {
+                // Use iterators for traversal
+                // 使用迭代器进行遍历
+                auto itRhs = rhs.digits.rbegin();
+                for (auto it = this->digits.rbegin(); it != this->digits.rend(); it++)
+                {
+                    if (*it == *itRhs)
+                    {
+                        itRhs++;
+                        continue;
+                    }
+                    else if (*it < *itRhs)
+                    {
+                        return true;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }
+                // Reaching here means the two numbers are equal, so return false
+                // 能走到这一步证明两数相等，所以return false
+                return false;
+            }
+        }
+        // For negative numbers
+        else
+        {
+            // Compare the number of digits first, the number with more digits is actually smaller
+            // 先比较位数，位数大的数必然更小
+            if (this->size() > rhs.size())
+            {
+                return true;
+            }
+            else if ((this->size()) < rhs.size())
+            {
+                return false;
+            }
+            // If the number of digits is the same, compare digit by digit
+            // 位数相同则一位一位比较
+            else
+            {
+                // Use iterators for traversal
+                // 使用迭代器进行遍历
+                auto itRhs = rhs.digits.rbegin();
+                for (auto it = this->digits.rbegin(); it != this->digits.rend(); it++)
+                {
+                    if (*it == *itRhs)
+                    {
+                        itRhs++;
+                        continue;
+                    }
+                    if (*it < *itRhs)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        return true;
+                    }
+                }
+                // Reaching here means the two numbers are equal, so return false
+                // 能走到这一步证明两数相等，所以return false
+                return false;
+            }
+        }
+    }
+}
+
+/**
+ * @brief > operator.
+ * > 运算符。
+ *
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigInt::operator>(const BigInt &rhs) const
+{
+    // If the signs are different
+    // 如果两数异号
     if (this->sign != rhs.sign)
     {
-        if (this->sign)
+        if (this->sign)
+        {
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    // If the signs are the same
+    // 如果两数同号
+    else
+    {
+        // For positive numbers or 0
+        // 两数为正数或0
+        if (this->sign)
+        {
+            // Compare the number of digits first, the number with more digits is definitely larger
+            // 先比较位数，位数大的数必然更大
+            if (this->size() > rhs.size())
+            {
+                return true;
+            }
+            else if ((this->size()) < rhs.size())
+            {
+                return false;
+            }
+            // If the number of digits is the same, compare digit by digit
+            // 位数相同则一位一位比较
+            else
+            {
+                // Use iterators for traversal
+                // 使用迭代器进行遍历
+                auto itRhs = rhs.digits.rbegin();
+                for (auto it = this->digits.rbegin(); it != this->digits.rend(); it++)
+                {
+                    if (*it == *itRhs)
+                    {
+                        itRhs++;
+                        continue;
+                    }
+                    else if (*it < *itRhs)
+                    {
+                        return false;
+                    }
+                    else
+                    {
+                        return true;
+                    }
+                }
+                // Reaching here means the two numbers are equal, so return false
+                // 能走到这一步证明两数相等，所以return false
+                return false;
+            }
+        }
+        // For negative numbers
+        // 两数为负数
+        else
+        {
+            // Compare the number of digits first, the number with more digits is actually smaller
+            // 先比较位数，位数大的数必然更小
+            if (this->size() > rhs.size())
+            {
+                return false;
+            }
+            else if ((this->size()) < rhs.size())
+            {
+                return true;
+            }
+            // If the number of digits is the same, compare digit by digit
+            // 位数相同则一位一位比较
+            else
+            {
+                // Use iterators for traversal
+                // 使用迭代器进行遍历
+                auto itRhs = rhs.digits.rbegin();
+                // for (size_t i = this->digits.size(); i >= 0; i--)
+                for (auto it = this->digits.rbegin(); it != this->digits.rend(); it++)
+                {
+                    // if (this->digits[i] == rhs.digits[i])
+                    if (*it == *itRhs)
+                    {
+                        itRhs++;
+                        continue;
+                    }
+                    // else if (this->digits[i] < rhs.digits[i])
+                    if (*it < *itRhs)
+                    {
+                        return true;
+                    }
+                    else
+                    {
+                        return false;
+                    }
+                }
+                // Reaching here means the two numbers are equal, so return false
+                // 能走到这一步证明两数相等，所以return false
+                return false;
+            }
+        }
+    }
+}
+
+/**
+ * @brief <= operator, directly negates the > operator.
+ * <= 运算符，直接取>运算符的负值。
+ *
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigInt::operator<=(const BigInt &rhs) const
+{
+    return !(*this > rhs);
+}
+
+/**
+ * @brief >= operator, directly negates the < operator.
+ * >= 运算符，直接取<运算符的负值。
+ *
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigInt::operator>=(const BigInt &rhs) const
+{
+    return !(*this < rhs);
+}
+
+/**
+ * @brief Overloaded << operator, writes the digits in chunks without building the whole string.
+ * A field width still goes through toString, because the padding needs the full length.
+ * << 运算符重载，分块写出数字而不构建完整字符串。
+ * 设置了字段宽度时仍通过 toString 输出，因为填充需要知道完整长度。
+ *
+ * @param os Output stream.输出流。
+ * @param num Value to be output.输出的值。
+ * @return ostream&
+ */
+ostream &operator<<(ostream &os, const BigInt &num)
+{
+    if (os.width() != 0)
+    {
+        os << num.toString();
+        return os;
+    }
+    num.writeTo(os);
+    return os;
+}
+
+/**
+ * @brief Size of the buffer used by the chunked writers.
+ * 分块写出时使用的缓冲区大小。
+ */
+static const size_t WRITE_CHUNK_SIZE = 1 << 16;
+
+/**
+ * @brief Converts the digits, most significant first, into a fixed buffer and passes every
+ * full chunk to sink, so peak memory does not grow with the number.
+ * 从最高位开始将数字转换到固定缓冲区中，并把每个写满的块交给 sink，因此峰值内存不随数字增长。
+ *
+ * @param sink Writes one chunk, returns false on error. 写出一个块，出错时返回 false。
+ * @return true All chunks were written. 所有块均已写出。
+ * @return false
+ */
+bool BigInt::writeChunks(const function<bool(const char *, size_t)> &sink) const
+{
+    char buffer[WRITE_CHUNK_SIZE];
+    size_t used = 0;
+    if (!this->sign)
+    {
+        buffer[used++] = '-';
+    }
+    const uint8_t *digits = this->digits.data();
+    for (size_t i = this->digits.size(); i > 0;)
+    {
+        size_t count = min(i, WRITE_CHUNK_SIZE - used);
+        for (size_t j = 0; j < count; ++j)
+        {
+            buffer[used + j] = static_cast<char>('0' + digits[i - 1 - j]);
+        }
+        used += count;
+        i -= count;
+        if (used == WRITE_CHUNK_SIZE || i == 0)
+        {
+            if (!sink(buffer, used))
+            {
+                return false;
+            }
+            used = 0;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the decimal digits to an output stream in chunks.
+ * 将十进制数字分块写入输出流。
+ *
+ * @param os Output stream. 输出流。
+ * @return true The stream is still good. 流仍处于正常状态。
+ * @return false
+ */
+bool BigInt::writeTo(ostream &os) const
+{
+    return this->writeChunks([&os](const char *data, size_t length)
+                             { return static_cast<bool>(os.write(data, static_cast<streamsize>(length))); });
+}
+
+/**
+ * @brief Writes the decimal digits to a C stream in chunks.
+ * 将十进制数字分块写入C流。
+ *
+ * @param file C stream. C流。
+ * @return true All digits were written. 所有数字均已写出。
+ * @return false
+ */
+bool BigInt::writeTo(FILE *file) const
+{
+    return this->writeChunks([file](const char *data, size_t length)
+                             { return fwrite(data, 1, length, file) == length; });
+}
+
+/**
+ * @brief Writes the decimal digits to a file descriptor in chunks, retrying partial writes.
+ * 将十进制数字分块写入文件描述符，部分写入时继续重试。
+ *
+ * @param fd File descriptor. 文件描述符。
+ * @return true All digits were written. 所有数字均已写出。
+ * @return false
+ */
+bool BigInt::writeTo(int fd) const
+{
+    return this->writeChunks([fd](const char *data, size_t length)
+                             {
+        while (length > 0)
+        {
+#ifdef _WIN32
+            int written = _write(fd, data, static_cast<unsigned int>(length));
+#else
+            ssize_t written = ::write(fd, data, length);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+#endif
+            if (written <= 0)
+            {
+                return false;
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+        return true; });
+}
+
+
+/**
+ * @brief Returns the number of digits.
+ * 返回数字长度（位数）。
+ *
+ * @return BigInt::size_t
+ */
+size_t BigInt::size() const
+{
+    return this->digits.size();
+}
+
+/**
+ * @brief Convert to string.
+ * 输出为字符串。
+ *
+ * @return string Output string.输出字符串。
+ */
+string BigInt::toString() const
+{
+    // If it is a negative number, start the string with a minus sign
+    // 如果是负数，则字符串以负号开头
+    size_t offset = this->sign ? 0 : 1;
+    size_t length = this->digits.size();
+    string output(offset + length, '-');
+    // Construct the string, long numbers in parallel ranges
+    // 构建字符串，长数字按区间并行构建
+    const uint8_t *digits = this->digits.data();
+    char *out = &output[offset];
+    forEachDigitRange(length, [digits, out, length](size_t begin, size_t end)
+                      {
+        for (size_t i = begin; i < end; ++i)
+        {
+            out[length - 1 - i] = static_cast<char>('0' + digits[i]);
+        } });
+    return output;
+}
+
+/**
+ * @brief Digits getter
+ *
+ * @return vector<uint8_t>
+ */
+vector<uint8_t> BigInt::getDigits() const
+{
+    return vector<uint8_t>(this->digits.begin(), this->digits.end());
+}
+
+/**
+ * @brief Sign getter
+ *
+ * @return true
+ * @return false
+ */
+bool BigInt::getSign() const
+{
+    return this->sign;
+}
+
+/**
+ * @brief Hash of the sign and digits. The digits are read 8 at a time as one 64-bit word, and each word
+ * is mixed into the state with a multiply and xor-shift.
+ * 符号和数字的哈希值。每次读取 8 位数字作为一个 64 位字，每个字通过乘法和异或移位混入状态。
+ *
+ * @return size_t
+ */
+size_t BigInt::hash() const
+{
+    const uint64_t multiplier = 0x9E3779B97F4A7C15ULL;
+    const uint8_t *data = this->digits.data();
+    size_t length = this->digits.size();
+    uint64_t state = (length * multiplier) ^ (this->sign ? 0 : 0xFFFFFFFFFFFFFFFFULL);
+
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        state = (state ^ word) * multiplier;
+        state ^= state >> 32;
+    }
+    // Remaining digits. data may be null for an empty buffer, so nothing is copied without a tail
+    // 剩余的数字。空缓冲区的 data 可能为空指针，因此没有剩余数字时不进行拷贝
+    uint64_t tail = 0;
+    if (i < length)
+    {
+        memcpy(&tail, data + i, length - i);
+    }
+    state = (state ^ tail) * multiplier;
+    state ^= state >> 29;
+    return static_cast<size_t>(state);
+}
+
+/**
+ * @brief Makes room for at least length digits, so that building a value of known size does not reallocate.
+ * 预留至少 length 位数字的空间，使构造已知大小的值时不重新分配。
+ *
+ * @param length
+ */
+void BigInt::reserve(size_t length)
+{
+    this->digits.reserve(length);
+}
+
+/**
+ * @brief Releases the spare capacity of the digits. With copy-on-write digits, a shared buffer is left alone.
+ * 释放数字的空闲容量。使用写时复制时，被共享的缓冲区保持不变。
+ */
+void BigInt::shrinkToFit()
+{
+    this->digits.shrinkToFit();
+}
+
+/**
+ * @brief Heap bytes held by the digits, which is their capacity. With copy-on-write digits the buffer is
+ * shared by the copies, and each of them reports it.
+ * 数字占用的堆内存字节数，即其容量。使用写时复制时缓冲区由各拷贝共享，每个拷贝都会报告它。
+ *
+ * @return size_t
+ */
+size_t BigInt::memoryUsage() const
+{
+    return this->digits.capacity() * sizeof(uint8_t);
+}
+
+/**
+ * @brief Heap bytes held by the digit buffers of all live BigInts, including the per-thread buffers
+ * the kernels keep between calls. Counted by DigitAllocator.
+ * 所有存活的 BigInt 的数字缓冲区占用的堆内存字节数，包括内核在调用之间保留的每线程缓冲区。由 DigitAllocator 统计。
+ *
+ * @return size_t
+ */
+size_t BigInt::liveBytes()
+{
+    return liveDigitBytes().load(memory_order_relaxed);
+}
+
+/**
+ * @brief + operator, implemented using +=.
+ * + 运算符，通过 += 实现。
+ *
+ * @param lhs
+ * @param rhs
+ * @return BigInt
+ */
+BigInt operator+(BigInt lhs, const BigInt &rhs)
+{
+    lhs += rhs;
+    return lhs;
+}
+
+/**
+ * @brief - operator, implemented using -=.
+ * - 运算符，通过 -= 实现。
+ *
+ * @param lhs
+ * @param rhs
+ * @return BigInt
+ */
+BigInt operator-(BigInt lhs, const BigInt &rhs)
+{
+    lhs -= rhs;
+    return lhs;
+}
+
+/**
+ * @brief * operator, implemented using *=.
+ * * 运算符，通过 *= 实现。
+ *
+ * @param lhs
+ * @param rhs
+ * @return BigInt
+ */
+BigInt operator*(BigInt lhs, const BigInt &rhs)
+{
+    lhs *= rhs;
+    return lhs;
+}
+
+/**
+ * @brief / operator, implemented using /=.
+ * / 运算符，通过 /= 实现。
+ *
+ * @param lhs
+ * @param rhs
+ * @return BigInt
+ */
+BigInt operator/(BigInt lhs, const BigInt &rhs)
+{
+    lhs /= rhs;
+    return lhs;
+}
+
+/**
+ * @brief % operator, implemented using %=.
+ * % 运算符，通过 %= 实现。
+ *
+ * @param lhs
+ * @param rhs
+ * @return BigInt
+ */
+BigInt operator%(BigInt lhs, const BigInt &rhs)
+{
+    lhs %= rhs;
+    return lhs;
+}
+
+/**
+ * @brief Utility function to compare absolute values.
+ * Only called in case of different signs, so no need to consider the same sign.
+ * 工具函数，比较绝对值大小。
+ * 只会在两数异号的情况下调用，所以不需要考虑两数同号的情况。
+ *
+ * @param lhs
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigInt::isAbsGreaterOrEqual(const BigInt &lhs, const BigInt &rhs)
+{
+    // Compare the digits directly instead of comparing negated copies
+    // 直接比较数字，而不是比较取负后的副本
+    if (lhs.digits.size() != rhs.digits.size())
+    {
+        return lhs.digits.size() > rhs.digits.size();
+    }
+    for (size_t i = lhs.digits.size(); i-- > 0;)
+    {
+        if (lhs.digits[i] != rhs.digits[i])
+        {
+            return lhs.digits[i] > rhs.digits[i];
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Utility function to subtract the smaller absolute value BigInt from the larger one.
+ * 工具函数，从绝对值大的 BigInt 中减去绝对值小的 BigInt。
+ *
+ * @param rhs
+ */
+void BigInt::subtractAbs(const BigInt &rhs)
+{
+    const DigitVector &rhsDigits = rhs.digits;
+    DigitVector &lhsDigits = this->digits.write();
+    bool borrow = false;
+    for (size_t i = 0; i < lhsDigits.size(); ++i)
+    {
+        int subtraction = int(lhsDigits[i]) - (i < rhsDigits.size() ? int(rhsDigits[i]) : 0) - borrow;
+        borrow = subtraction < 0;
+        if (borrow)
+        {
+            subtraction += 10;
+        }
+        lhsDigits[i] = static_cast<uint8_t>(subtraction);
+    }
+
+    // Remove leading zeros from the result
+    // 删除结果中的前导零
+    while (this->digits.size() > 1 && this->digits.back() == 0)
+    {
+        this->digits.pop_back();
+    }
+}
+
+/**
+ * @brief Utility function to replace the absolute value of this object with |rhs| - |this|.
+ * Requires |rhs| >= |this|.
+ * 工具函数，将当前对象的绝对值替换为 |rhs| - |this|。
+ * 要求 |rhs| >= |this|。
+ *
+ * @param rhs
+ */
+void BigInt::reverseSubtractAbs(const BigInt &rhs)
+{
+    const DigitVector &rhsDigits = rhs.digits;
+    DigitVector &lhsDigits = this->digits.write();
+    lhsDigits.resize(rhsDigits.size(), 0);
+    bool borrow = false;
+    for (size_t i = 0; i < lhsDigits.size(); ++i)
+    {
+        int subtraction = int(rhsDigits[i]) - int(lhsDigits[i]) - borrow;
+        borrow = subtraction < 0;
+        if (borrow)
+        {
+            subtraction += 10;
+        }
+        lhsDigits[i] = static_cast<uint8_t>(subtraction);
+    }
+}
+
+/**
+ * @brief Utility function to remove leading zeros and make the sign of 0 positive.
+ * 工具函数，删除前导零，并把0的符号设为正。
+ */
+void BigInt::normalize()
+{
+    while (this->digits.size() > 1 && this->digits.back() == 0)
+    {
+        this->digits.pop_back();
+    }
+    // If the final result is 0, forcefully set the sign to positive
+    // 如果最终结果为0，把符号强制设置为+
+    if ((this->digits.size() == 1) && (this->digits[0] == 0))
+    {
+        this->sign = true;
+    }
+    // Release the capacity left by a much larger intermediate value
+    // 释放较大的中间值留下的容量
+    const BigIntTuning &tuning = getTuning();
+    size_t length = this->digits.size();
+    size_t capacity = this->digits.capacity();
+    if (tuning.shrinkFactor != 0 && capacity > tuning.shrinkFactor * length && capacity - length >= tuning.shrinkMinimum)
+    {
+        this->digits.shrinkToFit();
+    }
+}
+
+/**
+ * @brief dst = a + b, written into the existing digits of dst so that its capacity is reused.
+ * dst may be a or b.
+ * dst = a + b，写入 dst 已有的数字存储中以复用其容量。
+ * dst 可以是 a 或 b。
+ *
+ * @param dst Destination. 目标。
+ * @param a
+ * @param b
+ */
+void add(BigInt &dst, const BigInt &a, const BigInt &b)
+{
+    // Addition is commutative, so dst == b is handled as dst += a
+    // 加法满足交换律，所以 dst == b 时按 dst += a 处理
+    if (&dst == &b)
+    {
+        dst.addSigned(a, a.sign);
+        return;
+    }
+    if (&dst != &a)
+    {
+        dst.digits = a.digits;
+        dst.sign = a.sign;
+    }
+    dst.addSigned(b, b.sign);
+}
+
+/**
+ * @brief dst = a - b, written into the existing digits of dst so that its capacity is reused.
+ * dst may be a or b.
+ * dst = a - b，写入 dst 已有的数字存储中以复用其容量。
+ * dst 可以是 a 或 b。
+ *
+ * @param dst Destination. 目标。
+ * @param a
+ * @param b
+ */
+void sub(BigInt &dst, const BigInt &a, const BigInt &b)
+{
+    // dst == b is computed as -(dst - a)
+    // dst == b 时按 -(dst - a) 计算
+    if (&dst == &b)
+    {
+        dst.addSigned(a, !a.sign);
+        if (!(dst.digits.size() == 1 && dst.digits[0] == 0))
+        {
+            dst.sign = !dst.sign;
+        }
+        return;
+    }
+    if (&dst != &a)
+    {
+        dst.digits = a.digits;
+        dst.sign = a.sign;
+    }
+    dst.addSigned(b, !b.sign);
+}
+
+/**
+ * @brief dst = a * b, written into the existing digits of dst so that its capacity is reused.
+ * dst may be a or b, in which case the product is built in a per-thread buffer that is then swapped with dst.
+ * dst = a * b，写入 dst 已有的数字存储中以复用其容量。
+ * dst 可以是 a 或 b，此时乘积先写入线程内的缓冲区，再与 dst 交换。
+ * A cancelled product leaves dst as 0 in both cases. 两种情况下被取消的乘积都使 dst 为0。
+ *
+ * @param dst Destination. 目标。
+ * @param a
+ * @param b
+ */
+void mul(BigInt &dst, const BigInt &a, const BigInt &b)
+{
+    // Handle the sign before dst is overwritten
+    // 在 dst 被覆盖之前处理符号
+    bool sign = !(a.sign ^ b.sign);
+    try
+    {
+        if (&dst == &a || &dst == &b)
+        {
+            thread_local DigitVector buffer;
+            multiplyDigits(a.digits, b.digits, buffer);
+            dst.digits.swap(buffer);
+        }
+        else
+        {
+            multiplyDigits(a.digits, b.digits, dst.digits.overwrite());
+        }
+    }
+    catch (const BigIntCancelled &)
+    {
+        // A cancelled product leaves dst as 0 rather than half-written digits, also when dst is an operand
+        // 被取消的乘积使 dst 为0，而不是写了一半的数字，dst 是操作数时也是如此
+        dst.digits.assign(1, 0);
+        dst.sign = true;
+        throw;
+    }
+    dst.sign = sign;
+    // Remove leading zeros from the result, the sign is positive by default when the result is 0
+    // 删除结果中的前导零，结果为0时默认符号为正
+    dst.normalize();
+}
+
+/**
+ * @brief Adds or subtracts a * b in place. The product is accumulated into the digits of this value
+ * by the fused kernel, and only its sign is combined with the sign of this value here: equal signs
+ * add the magnitudes, different signs subtract them and flip the sign when the result crosses zero.
+ * An operand that is this value is copied first (O(1) with copy-on-write digits).
+ * 原地加上或减去 a * b。乘积由融合内核累加到本值的数字上，这里只把乘积的符号与本值的符号合并：
+ * 同号时绝对值相加，异号时绝对值相减，结果越过零时改变符号。
+ * 与本值相同的操作数先被拷贝（使用写时复制数字存储时为 O(1)）。
+ *
+ * @param a
+ * @param b
+ * @param subtract true to subtract the product. true 表示减去乘积。
+ */
+void BigInt::multiplyAdd(const BigInt &a, const BigInt &b, bool subtract)
+{
+    if (this == &a || this == &b)
+    {
+        BigInt copy = *this;
+        multiplyAdd(this == &a ? copy : a, this == &b ? copy : b, subtract);
+        return;
+    }
+    const DigitVector &aDigits = a.digits;
+    const DigitVector &bDigits = b.digits;
+    if ((aDigits.size() == 1 && aDigits[0] == 0) || (bDigits.size() == 1 && bDigits[0] == 0))
+    {
+        return;
+    }
+    bool productSign = !(a.sign ^ b.sign) ^ subtract;
+    try
+    {
+        if (accumulateProduct(aDigits, bDigits, this->digits.write(), productSign != this->sign))
+        {
+            this->sign = !this->sign;
+        }
+    }
+    catch (const BigIntCancelled &)
+    {
+        // Like mul, a cancelled operation leaves 0 rather than half-accumulated digits
+        // 与 mul 一样，被取消的运算留下0，而不是累加了一半的数字
+        this->digits.assign(1, 0);
+        this->sign = true;
+        throw;
+    }
+    normalize();
+}
+
+/**
+ * @brief Fused multiply-add, dst += a * b. Operands may alias dst.
+ * 融合乘加，dst += a * b。操作数可以与 dst 相同。
+ *
+ * @param dst
+ * @param a
+ * @param b
+ */
+void addmul(BigInt &dst, const BigInt &a, const BigInt &b)
+{
+    dst.multiplyAdd(a, b, false);
+}
+
+/**
+ * @brief Fused multiply-subtract, dst -= a * b. Operands may alias dst.
+ * 融合乘减，dst -= a * b。操作数可以与 dst 相同。
+ *
+ * @param dst
+ * @param a
+ * @param b
+ */
+void submul(BigInt &dst, const BigInt &a, const BigInt &b)
+{
+    dst.multiplyAdd(a, b, true);
+}
+
+/**
+ * @brief Multiplies on another thread. The operands are copied first (O(1) with copy-on-write digits).
+ * The kernels check token at their safe points and report progress to it, so the caller can cancel the
+ * work, give it a deadline or watch it. A cancelled or expired multiplication makes the future throw
+ * BigIntCancelled.
+ * 在另一个线程上相乘。操作数先被拷贝（使用写时复制数字存储时为 O(1)）。
+ * 内核在安全点检查 token 并向其报告进度，因此调用者可以取消运算、为其设置截止时间或观察进度。
+ * 乘法被取消或过期时 future 抛出 BigIntCancelled。
+ *
+ * @param a
+ * @param b
+ * @param token Cancellation token shared with the caller. 与调用者共享的取消令牌。
+ * @return future<BigInt>
+ */
+future<BigInt> BigInt::asyncMul(const BigInt &a, const BigInt &b, const BigIntCancelToken &token)
+{
+    return async(launch::async, [a, b, token]()
+                 {
+        BigIntCancelScope scope(token);
+        token.check();
+        BigInt product;
+        mul(product, a, b);
+        token.setProgress(1);
+        return product; });
+}
+
+/**
+ * @brief Largest scalar handled by the single-word kernels. Below it, digit * scalar + carry and
+ * remainder * 10 + digit both fit in uint64_t.
+ * 单字内核能处理的最大标量。在此之下，digit * scalar + carry 和 remainder * 10 + digit 都不会超出 uint64_t。
+ */
+static const uint64_t SINGLE_WORD_LIMIT = 1000000000000000000ULL;
+
+/**
+ * @brief Splits an unsigned 64-bit integer into little-endian decimal digits.
+ * 将无符号 64 位整数拆分为小端存储的十进制数字。
+ *
+ * @param magnitude
+ * @param out Receives at most 20 digits. 最多接收 20 位数字。
+ * @return size_t Number of digits, at least 1. 位数，至少为 1。
+ */
+static size_t splitMagnitude(uint64_t magnitude, uint8_t *out)
+{
+    size_t length = 0;
+    do
+    {
+        out[length++] = static_cast<uint8_t>(magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    return length;
+}
+
+/**
+ * @brief Compares the absolute value of a digit vector with a digit array.
+ * 比较数字向量与数字数组的绝对值。
+ *
+ * @param lhs
+ * @param rhs
+ * @param rhsLength
+ * @return int -1, 0 or 1.
+ */
+static int compareAbsDigits(const DigitVector &lhs, const uint8_t *rhs, size_t rhsLength)
+{
+    if (lhs.size() != rhsLength)
+    {
+        return lhs.size() > rhsLength ? 1 : -1;
+    }
+    for (size_t i = rhsLength; i-- > 0;)
+    {
+        if (lhs[i] != rhs[i])
+        {
+            return lhs[i] > rhs[i] ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Builds a BigInt from an absolute value and a sign.
+ * 由绝对值和符号构造 BigInt。
+ *
+ * @param magnitude Absolute value. 绝对值。
+ * @param positive Sign. 符号。
+ * @return BigInt
+ */
+BigInt BigInt::fromMagnitude(uint64_t magnitude, bool positive)
+{
+    uint8_t buffer[20];
+    size_t length = splitMagnitude(magnitude, buffer);
+    BigInt result;
+    result.digits.assign(buffer, buffer + length);
+    result.sign = positive;
+    result.normalize();
+    return result;
+}
+
+/**
+ * @brief Builds a BigInt from little-endian digits, used by the _big literal.
+ * 由小端存储的数字构造 BigInt，供 _big 字面量使用。
+ *
+ * @param digits Little-endian digits. 小端存储的数字。
+ * @param length Number of digits. 位数。
+ * @param positive Sign. 符号。
+ * @return BigInt
+ */
+BigInt BigInt::fromDigits(const uint8_t *digits, size_t length, bool positive)
+{
+    BigInt result;
+    result.digits.assign(digits, digits + length);
+    result.sign = positive;
+    result.normalize();
+    return result;
+}
+
+/**
+ * @brief Adds a built-in integer given as absolute value and sign, working on the digits in place.
+ * 加上以绝对值和符号给出的内置整数，原地处理数字。
+ *
+ * @param magnitude Absolute value. 绝对值。
+ * @param positive Sign. 符号。
+ */
+void BigInt::addScalar(uint64_t magnitude, bool positive)
+{
+    if (magnitude == 0)
+    {
+        return;
+    }
+    uint8_t buffer[20];
+    size_t length = splitMagnitude(magnitude, buffer);
+    // 0 takes the sign of the scalar
+    // 0 取标量的符号
+    if (this->digits.size() == 1 && this->digits[0] == 0)
+    {
+        this->sign = positive;
+    }
+
+    // Addition with the same sign
+    // 同号相加
+    DigitVector &digits = this->digits.write();
+    if (this->sign == positive)
+    {
+        reserveDigits(digits, std::max(digits.size(), length) + 1);
+        int carry = 0;
+        for (size_t i = 0; i < length || carry; ++i)
         {
-            return true;
+            if (i == digits.size())
+            {
+                digits.push_back(0);
+            }
+            int current = digits[i] + (i < length ? buffer[i] : 0) + carry;
+            carry = current >= 10;
+            digits[i] = static_cast<uint8_t>(carry ? current - 10 : current);
         }
-        else
+        return;
+    }
+
+    // Addition with different signs, subtract the smaller absolute value from the larger one
+    // 异号相加，从绝对值大的数中减去绝对值小的数
+    bool borrow = false;
+    if (compareAbsDigits(digits, buffer, length) >= 0)
+    {
+        for (size_t i = 0; i < digits.size() && (i < length || borrow); ++i)
         {
-            return false;
+            int subtraction = int(digits[i]) - (i < length ? int(buffer[i]) : 0) - borrow;
+            borrow = subtraction < 0;
+            digits[i] = static_cast<uint8_t>(borrow ? subtraction + 10 : subtraction);
         }
     }
-    // If the signs are the same
-    // 如果两数同号
     else
     {
-        // For positive numbers or 0
-        // 两数为正数或0
-        if (this->sign)
+        digits.resize(length, 0);
+        for (size_t i = 0; i < length; ++i)
         {
-            // Compare the number of digits first, the number with more digits is definitely larger
-            // 先比较位数，位数大的数必然更大
-            if (this->size() > rhs.size())
-            {
-                return true;
-            }
-            else if ((this->size()) < rhs.size())
-            {
-                return false;
-            }
-            // If the number of digits is the same, compare digit by digit
-            // 位数相同则一位一位比较
-            else
+            int subtraction = int(buffer[i]) - int(digits[i]) - borrow;
+            borrow = subtraction < 0;
+            digits[i] = static_cast<uint8_t>(borrow ? subtraction + 10 : subtraction);
+        }
+        this->sign = positive;
+    }
+    normalize();
+}
+
+/**
+ * @brief mul_1: multiplies by a built-in integer in one linear pass. The only growth is the final carry.
+ * Scalars above SINGLE_WORD_LIMIT fall back to the general multiplication.
+ * mul_1：一次线性遍历乘以内置整数，唯一的增长来自最后的进位。
+ * 大于 SINGLE_WORD_LIMIT 的标量退回到一般乘法。
+ *
+ * @param magnitude Absolute value. 绝对值。
+ * @param positive Sign. 符号。
+ */
+void BigInt::mulScalar(uint64_t magnitude, bool positive)
+{
+    if (magnitude > SINGLE_WORD_LIMIT)
+    {
+        *this *= fromMagnitude(magnitude, positive);
+        return;
+    }
+    if (magnitude == 0)
+    {
+        this->digits.assign(1, 0);
+        this->sign = true;
+        return;
+    }
+    // The carry stays below magnitude, so digit * magnitude + carry < 10 * magnitude
+    // 进位始终小于 magnitude，所以 digit * magnitude + carry < 10 * magnitude
+    DigitVector &digits = this->digits.write();
+    uint64_t carry = 0;
+    for (size_t i = 0; i < digits.size(); ++i)
+    {
+        uint64_t current = digits[i] * magnitude + carry;
+        digits[i] = static_cast<uint8_t>(current % 10);
+        carry = current / 10;
+    }
+    if (carry != 0)
+    {
+        // The carry has at most 19 digits
+        // 进位最多有19位
+        reserveDigits(digits, digits.size() + 19);
+    }
+    while (carry != 0)
+    {
+        digits.push_back(static_cast<uint8_t>(carry % 10));
+        carry /= 10;
+    }
+    this->sign = !(this->sign ^ positive);
+    normalize();
+}
+
+/**
+ * @brief div_1: divides by a built-in integer in one linear pass from the most significant digit,
+ * truncating towards zero. Keeps either the quotient or the remainder, which has the sign of the dividend.
+ * div_1：从最高位开始一次线性遍历除以内置整数，向零截断。保留商或余数，余数与被除数同号。
+ *
+ * @param magnitude Absolute value of the divisor. 除数的绝对值。
+ * @param positive Sign of the divisor. 除数的符号。
+ * @param keepRemainder true to keep the remainder, false to keep the quotient. true 保留余数，false 保留商。
+ */
+void BigInt::divScalar(uint64_t magnitude, bool positive, bool keepRemainder)
+{
+    if (magnitude == 0)
+    {
+        throw runtime_error("Division by zero");
+    }
+    uint64_t remainder = divideAbs(magnitude, !keepRemainder);
+
+    if (keepRemainder)
+    {
+        uint8_t buffer[20];
+        size_t length = splitMagnitude(remainder, buffer);
+        this->digits.assign(buffer, buffer + length);
+    }
+    else
+    {
+        this->sign = !(this->sign ^ positive);
+    }
+    normalize();
+}
+
+/**
+ * @brief The div_1 pass: divides the absolute value by a non-zero magnitude, from the most significant digit.
+ * The quotient may have leading zeros, the caller normalizes.
+ * div_1 遍历：从最高位开始用非零的 magnitude 除绝对值。商可能有前导零，由调用者规范化。
+ *
+ * @param magnitude Divisor. 除数。
+ * @param storeQuotient Whether to overwrite the digits with the quotient. 是否用商覆盖数字。
+ * @return uint64_t Remainder. 余数。
+ */
+uint64_t BigInt::divideAbs(uint64_t magnitude, bool storeQuotient)
+{
+    // The remainder only reads the digits, the quotient overwrites them in place
+    // 求余数时只读取数字，求商时原地覆盖数字
+    DigitVector *quotientDigits = storeQuotient ? &this->digits.write() : nullptr;
+    const DigitVector &digits = quotientDigits != nullptr ? *quotientDigits : this->digits.read();
+    uint64_t remainder = 0;
+    for (size_t i = digits.size(); i-- > 0;)
+    {
+        uint64_t quotient;
+        if (magnitude <= SINGLE_WORD_LIMIT)
+        {
+            uint64_t current = remainder * 10 + digits[i];
+            quotient = current / magnitude;
+            remainder = current % magnitude;
+        }
+        // remainder * 10 could overflow, so add the remainder ten times modulo magnitude
+        // remainder * 10 可能溢出，所以对 magnitude 取模累加十次余数
+        else
+        {
+            uint64_t current = digits[i];
+            quotient = 0;
+            for (int k = 0; k < 10; ++k)
             {
-                // Use iterators for traversal
-                // 使用迭代器进行遍历
-                auto itRhs = rhs.digits.rbegin();
-                for (auto it = this->digits.rbegin(); it != this->digits.rend(); it++)
+                if (current >= magnitude - remainder)
                 {
-                    if (*it == *itRhs)
-                    {
-                        itRhs++;
-                        continue;
-                    }
-                    else if (*it < *itRhs)
-                    {
-                        return false;
-                    }
-                    else
-                    {
-                        return true;
-                    }
+                    current -= magnitude - remainder;
+                    ++quotient;
+                }
+                else
+                {
+                    current += remainder;
                 }
-                // Reaching here means the two numbers are equal, so return false
-                // 能走到这一步证明两数相等，所以return false
-                return false;
             }
+            remainder = current;
         }
-        // For negative numbers
-        // 两数为负数
-        else
+        if (quotientDigits != nullptr)
         {
-            // Compare the number of digits first, the number with more digits is actually smaller
-            // 先比较位数，位数大的数必然更小
-            if (this->size() > rhs.size())
+            (*quotientDigits)[i] = static_cast<uint8_t>(quotient);
+        }
+    }
+    return remainder;
+}
+
+/**
+ * @brief Number of leading digits of the divisor used to estimate a quotient digit, so that the
+ * estimate and the window of the remainder both fit in 64 bits.
+ * 用于估计一位商的除数前导位数，使估计值和余数窗口都能放进 64 位。
+ */
+static const size_t QUOTIENT_ESTIMATE_DIGITS = 17;
+
+/**
+ * @brief Value of the count most significant digits of a little-endian digit array.
+ * 小端存储的数字数组中最高 count 位的值。
+ *
+ * @param digits
+ * @param length Number of digits, at least count. 位数，不少于 count。
+ * @param count At most 19. 不超过 19。
+ * @return uint64_t
+ */
+static uint64_t leadingDigits(const uint8_t *digits, size_t length, size_t count)
+{
+    uint64_t value = 0;
+    for (size_t i = length; i-- > length - count;)
+    {
+        value = value * 10 + digits[i];
+    }
+    return value;
+}
+
+/**
+ * @brief Subtracts rhs from lhs in place and removes the leading zeros, requires lhs >= rhs.
+ * 原地从 lhs 中减去 rhs 并删除前导零，要求 lhs >= rhs。
+ *
+ * @param lhs
+ * @param rhs
+ * @param rhsLength
+ */
+static void subtractDigits(DigitVector &lhs, const uint8_t *rhs, size_t rhsLength)
+{
+    int borrow = 0;
+    for (size_t i = 0; i < lhs.size() && (i < rhsLength || borrow != 0); ++i)
+    {
+        int current = lhs[i] - borrow - (i < rhsLength ? rhs[i] : 0);
+        borrow = current < 0;
+        lhs[i] = static_cast<uint8_t>(current + 10 * borrow);
+    }
+    while (lhs.size() > 1 && lhs.back() == 0)
+    {
+        lhs.pop_back();
+    }
+}
+
+/**
+ * @brief Schoolbook long division of normalized absolute values, one quotient digit per dividend digit.
+ * Each quotient digit is estimated from the leading digits of the remainder window and the divisor,
+ * then corrected by at most a few subtractions, so one digit costs O(m).
+ * 规范化绝对值的手算长除法，被除数的每一位产生一位商。
+ * 每一位商由余数窗口和除数的前导位估计，再经过最多几次减法修正，所以每一位的代价为 O(m)。
+ *
+ * @param a Dividend. 被除数。
+ * @param b Divisor, longer than one word. 除数，长度超过一个字。
+ * @param quotient Receives the normalized quotient. 接收规范化的商。
+ * @param remainder Receives the normalized remainder. 接收规范化的余数。
+ */
+static void divideDigits(const DigitVector &a, const DigitVector &b, DigitVector &quotient, DigitVector &remainder)
+{
+    size_t m = b.size();
+    if (compareAbsDigits(a, b.data(), m) < 0)
+    {
+        quotient.assign(1, 0);
+        remainder = a;
+        return;
+    }
+    quotient.assign(a.size() - m + 1, 0);
+    uint64_t divisorTop = leadingDigits(b.data(), m, QUOTIENT_ESTIMATE_DIGITS);
+    // The window starts with the top m - 1 digits, each step brings down the next digit
+    // 窗口从最高的 m - 1 位开始，每一步移入下一位
+    remainder.assign(a.end() - (m - 1), a.end());
+    DigitVector product;
+    product.reserve(m + 1);
+    for (size_t i = quotient.size(); i-- > 0;)
+    {
+        if (i % 256 == 0)
+        {
+            BigIntCancelScope::checkpoint();
+        }
+        remainder.insert(remainder.begin(), a[i]);
+        while (remainder.size() > 1 && remainder.back() == 0)
+        {
+            remainder.pop_back();
+        }
+        if (remainder.size() < m)
+        {
+            continue;
+        }
+        // The window has m or m + 1 digits, align its leading digits with those of the divisor
+        // 窗口有 m 或 m + 1 位，使其前导位与除数的前导位对齐
+        size_t windowDigits = QUOTIENT_ESTIMATE_DIGITS + (remainder.size() - m);
+        uint64_t digit = std::min<uint64_t>(leadingDigits(remainder.data(), remainder.size(), windowDigits) / divisorTop, 9);
+        if (digit > 0)
+        {
+            product.assign(m + 1, 0);
+            uint32_t carry = 0;
+            for (size_t j = 0; j < m; ++j)
             {
-                return false;
+                uint32_t current = b[j] * static_cast<uint32_t>(digit) + carry;
+                product[j] = static_cast<uint8_t>(current % 10);
+                carry = current / 10;
             }
-            else if ((this->size()) < rhs.size())
+            product[m] = static_cast<uint8_t>(carry);
+            if (product.back() == 0)
             {
-                return true;
+                product.pop_back();
             }
-            // If the number of digits is the same, compare digit by digit
-            // 位数相同则一位一位比较
-            else
+            // Truncating the divisor can overestimate by one
+            // 截断除数可能使估计值偏大一
+            while (compareAbsDigits(product, remainder.data(), remainder.size()) > 0)
             {
-                // Use iterators for traversal
-                // 使用迭代器进行遍历
-                auto itRhs = rhs.digits.rbegin();
-                // for (size_t i = this->digits.size(); i >= 0; i--)
-                for (auto it = this->digits.rbegin(); it != this->digits.rend(); it++)
-                {
-                    // if (this->digits[i] == rhs.digits[i])
-                    if (*it == *itRhs)
-                    {
-                        itRhs++;
-                        continue;
-                    }
-                    // else if (this->digits[i] < rhs.digits[i])
-                    if (*it < *itRhs)
-                    {
-                        return true;
-                    }
-                    else
-                    {
-                        return false;
-                    }
-                }
-                // Reaching here means the two numbers are equal, so return false
-                // 能走到这一步证明两数相等，所以return false
-                return false;
+                subtractDigits(product, b.data(), m);
+                --digit;
             }
+            subtractDigits(remainder, product.data(), product.size());
         }
+        // Truncating the window can underestimate by one
+        // 截断窗口可能使估计值偏小一
+        while (compareAbsDigits(remainder, b.data(), m) >= 0)
+        {
+            subtractDigits(remainder, b.data(), m);
+            ++digit;
+        }
+        quotient[i] = static_cast<uint8_t>(digit);
+    }
+    while (quotient.size() > 1 && quotient.back() == 0)
+    {
+        quotient.pop_back();
+    }
+}
+
+/**
+ * @brief Divisors with at least this many digits, and quotients with at least this many digits, are divided
+ * with a Newton reciprocal instead of schoolbook long division.
+ * 除数和商都不少于该位数时，使用牛顿法倒数除法，而不是手算长除法。
+ */
+static const size_t NEWTON_DIVISION_THRESHOLD = 192;
+
+/**
+ * @brief Length below which reciprocalDigits uses schoolbook long division.
+ * reciprocalDigits 在长度低于该值时使用手算长除法。
+ */
+static const size_t RECIPROCAL_LEAF_LENGTH = 64;
+
+/**
+ * @brief Removes the leading zeros of a digit vector, keeping at least one digit.
+ * 删除数字向量的前导零，至少保留一位。
+ *
+ * @param digits
+ */
+static void trimDigits(DigitVector &digits)
+{
+    while (digits.size() > 1 && digits.back() == 0)
+    {
+        digits.pop_back();
+    }
+    if (digits.empty())
+    {
+        digits.push_back(0);
+    }
+}
+
+/**
+ * @brief Adds rhs to lhs in place.
+ * 原地把 rhs 加到 lhs 上。
+ *
+ * @param lhs
+ * @param rhs
+ * @param rhsLength
+ */
+static void addDigits(DigitVector &lhs, const uint8_t *rhs, size_t rhsLength)
+{
+    if (lhs.size() < rhsLength)
+    {
+        lhs.resize(rhsLength, 0);
+    }
+    int carry = 0;
+    for (size_t i = 0; i < lhs.size() && (i < rhsLength || carry != 0); ++i)
+    {
+        int current = lhs[i] + carry + (i < rhsLength ? rhs[i] : 0);
+        carry = current >= 10;
+        lhs[i] = static_cast<uint8_t>(current - 10 * carry);
+    }
+    if (carry != 0)
+    {
+        lhs.push_back(1);
+    }
+}
+
+/**
+ * @brief Trimmed product of two digit vectors.
+ * 两个数字向量的乘积，已删除前导零。
+ *
+ * @param a
+ * @param b
+ * @return DigitVector
+ */
+static DigitVector productDigits(const DigitVector &a, const DigitVector &b)
+{
+    DigitVector product;
+    multiplyDigits(a, b, product);
+    trimDigits(product);
+    return product;
+}
+
+/**
+ * @brief The digits of value divided by 10^count, which drops the count lowest digits.
+ * value 除以 10^count 的数字，即去掉最低的 count 位。
+ *
+ * @param value
+ * @param count
+ * @return DigitVector
+ */
+static DigitVector shiftDownDigits(const DigitVector &value, size_t count)
+{
+    if (count >= value.size())
+    {
+        return DigitVector(1, 0);
+    }
+    return DigitVector(value.begin() + count, value.end());
+}
+
+/**
+ * @brief floor(10^(2m) / p) for a divisor of m digits. The reciprocal r of the top h = m/2 + 2 digits,
+ * shifted into place as x = r * 10^(m - h), is accurate to about m/2 digits. One Newton step
+ * x + x(10^(2m) - px) / 10^(2m) doubles that, and a few additions or subtractions of p make the result exact.
+ * The low digits of x are zero and the step only needs the leading digits of the error, so the work is about
+ * two products of m by m/2 digits plus the recursion.
+ * m 位除数 p 的 floor(10^(2m) / p)。最高 h = m/2 + 2 位的倒数 r 移位为 x = r * 10^(m - h) 后约有 m/2 位精度。
+ * 一次牛顿迭代 x + x(10^(2m) - px) / 10^(2m) 使精度加倍，再加减几次 p 使结果精确。
+ * x 的低位为零，而迭代只需要误差的前导位，所以工作量约为两次 m 乘 m/2 位的乘法加上递归。
+ *
+ * @param p Normalized divisor of at least QUOTIENT_ESTIMATE_DIGITS digits. 规范化的除数，至少 QUOTIENT_ESTIMATE_DIGITS 位。
+ * @return DigitVector
+ */
+static DigitVector reciprocalDigits(const DigitVector &p)
+{
+    size_t m = p.size();
+    DigitVector power(2 * m + 1, 0);
+    power.back() = 1;
+    if (m <= RECIPROCAL_LEAF_LENGTH)
+    {
+        DigitVector x;
+        DigitVector remainder;
+        divideDigits(power, p, x, remainder);
+        return x;
+    }
+    size_t high = m / 2 + 2;
+    size_t shift = m - high;
+    DigitVector r = reciprocalDigits(DigitVector(p.end() - high, p.end()));
+
+    // Error 10^(2m) - p * r * 10^shift, it may have either sign
+    // 误差 10^(2m) - p * r * 10^shift，可正可负
+    DigitVector product = productDigits(p, r);
+    product.insert(product.begin(), shift, 0);
+    bool below = compareAbsDigits(product, power.data(), power.size()) <= 0;
+    DigitVector error = below ? power : product;
+    if (below)
+    {
+        subtractDigits(error, product.data(), product.size());
+    }
+    else
+    {
+        subtractDigits(error, power.data(), power.size());
+    }
+
+    // Newton step r * error / 10^(m + high), from the top shift + 3 digits of the error
+    // 牛顿迭代步长 r * error / 10^(m + high)，只用误差最高的 shift + 3 位
+    size_t dropped = error.size() > shift + 3 ? error.size() - (shift + 3) : 0;
+    DigitVector step = shiftDownDigits(productDigits(r, shiftDownDigits(error, dropped)), m + high - dropped);
+    DigitVector x(shift, 0);
+    x.insert(x.end(), r.begin(), r.end());
+    DigitVector stepProduct = productDigits(p, step);
+    if (below)
+    {
+        addDigits(x, step.data(), step.size());
+        addDigits(product, stepProduct.data(), stepProduct.size());
+    }
+    else
+    {
+        subtractDigits(x, step.data(), step.size());
+        subtractDigits(product, stepProduct.data(), stepProduct.size());
     }
+    trimDigits(x);
+    trimDigits(product);
+
+    // Make it exact: 0 <= 10^(2m) - px < p
+    // 使结果精确：0 <= 10^(2m) - px < p
+    const uint8_t one = 1;
+    while (compareAbsDigits(product, power.data(), power.size()) > 0)
+    {
+        subtractDigits(x, &one, 1);
+        subtractDigits(product, p.data(), m);
+    }
+    subtractDigits(power, product.data(), product.size());
+    while (compareAbsDigits(power, p.data(), m) >= 0)
+    {
+        addDigits(x, &one, 1);
+        subtractDigits(power, p.data(), m);
+    }
+    return x;
 }
 
 /**
- * @brief <= operator, directly negates the > operator.
- * <= 运算符，直接取>运算符的负值。
+ * @brief Long division by a large divisor with its Newton reciprocal R = floor(10^(2m) / p). The dividend
+ * is taken m digits at a time from the top, like one digit of schoolbook division in base 10^m. Each step
+ * divides t = remainder * 10^m + block, which is below 10^(2m), by estimating the quotient from the top m + 1
+ * digits of t and R, at most three below the true quotient, and correcting it. Each block costs two products instead of m^2 operations.
+ * 借助牛顿法倒数 R = floor(10^(2m) / p) 除以大除数。被除数从最高位开始每次取 m 位，
+ * 相当于以 10^m 为基数的手算除法的一位。每一步用 t 的最高 m + 1 位和 R 估计 t = 余数 * 10^m + 块
+ * （小于 10^(2m)）除以 p 的商，估计值最多比真实的商小三，再加以修正。每块的代价是两次乘法，而不是 m^2 次运算。
  *
- * @param rhs
- * @return true
- * @return false
+ * @param a Dividend. 被除数。
+ * @param p Divisor, at least NEWTON_DIVISION_THRESHOLD digits. 除数，至少 NEWTON_DIVISION_THRESHOLD 位。
+ * @param reciprocal reciprocalDigits(p).
+ * @param quotient Receives the normalized quotient. 接收规范化的商。
+ * @param remainder Receives the normalized remainder. 接收规范化的余数。
  */
-bool BigInt::operator<=(const BigInt &rhs) const
+static void divideNewton(const DigitVector &a, const DigitVector &p, const DigitVector &reciprocal, DigitVector &quotient, DigitVector &remainder)
 {
-    return !(*this > rhs);
+    size_t m = p.size();
+    size_t n = a.size();
+    quotient.assign(n, 0);
+    remainder.assign(1, 0);
+    const uint8_t one = 1;
+    size_t length = n % m == 0 ? m : n % m;
+    for (size_t start = n - length;; start -= m, length = m)
+    {
+        DigitVector block(a.begin() + start, a.begin() + start + length);
+        block.insert(block.end(), remainder.begin(), remainder.end());
+        trimDigits(block);
+        // The top m + 1 digits of t are enough for an estimate at most three below the quotient
+        // t 的最高 m + 1 位足以得到最多比商小三的估计值
+        DigitVector digit = shiftDownDigits(productDigits(shiftDownDigits(block, m - 1), reciprocal), m + 1);
+        DigitVector product = productDigits(digit, p);
+        subtractDigits(block, product.data(), product.size());
+        while (compareAbsDigits(block, p.data(), m) >= 0)
+        {
+            addDigits(digit, &one, 1);
+            subtractDigits(block, p.data(), m);
+        }
+        copy(digit.begin(), digit.begin() + min(digit.size(), length), quotient.begin() + start);
+        remainder.swap(block);
+        if (start == 0)
+        {
+            break;
+        }
+    }
+    trimDigits(quotient);
 }
 
 /**
- * @brief >= operator, directly negates the < operator.
- * >= 运算符，直接取<运算符的负值。
+ * @brief Truncating division by a BigInt. Divisors that fit in a word take the div_1 pass,
+ * longer ones the schoolbook long division. Keeps either the quotient or the remainder,
+ * which has the sign of the dividend.
+ * 除以 BigInt 的截断除法。能放进一个字的除数走 div_1 遍历，更长的除数走手算长除法。
+ * 保留商或余数，余数与被除数同号。
  *
- * @param rhs
- * @return true
- * @return false
+ * @param rhs Divisor, may alias this. 除数，可以与 this 相同。
+ * @param keepRemainder true to keep the remainder, false to keep the quotient. true 保留余数，false 保留商。
  */
-bool BigInt::operator>=(const BigInt &rhs) const
+void BigInt::divLong(const BigInt &rhs, bool keepRemainder)
 {
-    return !(*this < rhs);
+    const DigitVector &divisor = rhs.digits;
+    if (divisor.size() < 19)
+    {
+        uint64_t magnitude = leadingDigits(divisor.data(), divisor.size(), divisor.size());
+        divScalar(magnitude, rhs.sign, keepRemainder);
+        return;
+    }
+    bool divisorSign = rhs.sign;
+    DigitVector quotient;
+    DigitVector remainder;
+    if (divisor.size() >= NEWTON_DIVISION_THRESHOLD && this->digits.size() >= divisor.size() + NEWTON_DIVISION_THRESHOLD)
+    {
+        divideNewton(this->digits, divisor, reciprocalDigits(divisor), quotient, remainder);
+    }
+    else
+    {
+        divideDigits(this->digits, divisor, quotient, remainder);
+    }
+    if (keepRemainder)
+    {
+        this->digits.overwrite().swap(remainder);
+    }
+    else
+    {
+        this->digits.overwrite().swap(quotient);
+        this->sign = !(this->sign ^ divisorSign);
+    }
+    normalize();
 }
 
 /**
- * @brief Overloaded << operator, directly calls the toString method.
- * << 运算符重载，直接调用 toString 方法。
+ * @brief Euclid's algorithm on the absolute values with long division. Once the divisor fits in a word,
+ * the rest of the algorithm runs on machine integers.
+ * 用长除法对绝对值执行欧几里得算法。除数能放进一个字之后，其余步骤在机器整数上进行。
  *
- * @param os Output stream.输出流。
- * @param num Value to be output.输出的值。
- * @return ostream&
+ * @param a
+ * @param b
+ * @return BigInt Non-negative greatest common divisor. 非负的最大公约数。
  */
-ostream &operator<<(ostream &os, const BigInt &num)
+BigInt gcd(const BigInt &a, const BigInt &b)
 {
-    os << num.toString();
-    return os;
+    BigInt x = a;
+    BigInt y = b;
+    x.sign = true;
+    y.sign = true;
+    while (y.digits.size() >= 19)
+    {
+        BigIntCancelScope::checkpoint();
+        x %= y;
+        swap(x, y);
+    }
+    uint64_t small = leadingDigits(y.digits.read().data(), y.digits.size(), y.digits.size());
+    if (small == 0)
+    {
+        return x;
+    }
+    uint64_t large = x.divideAbs(small, false);
+    while (large != 0)
+    {
+        uint64_t next = small % large;
+        small = large;
+        large = next;
+    }
+    return BigInt::fromMagnitude(small, true);
 }
 
-
 /**
- * @brief Returns the number of digits.
- * 返回数字长度（位数）。
+ * @brief Compares with a built-in integer given as absolute value and sign.
+ * 与以绝对值和符号给出的内置整数比较。
  *
- * @return BigInt::size_t
+ * @param magnitude Absolute value. 绝对值。
+ * @param positive Sign. 符号。
+ * @return int -1, 0 or 1.
  */
-size_t BigInt::size() const
+int BigInt::compareScalar(uint64_t magnitude, bool positive) const
 {
-    return this->digits.size();
+    // 0 is positive
+    // 0 为正
+    positive = positive || magnitude == 0;
+    if (this->sign != positive)
+    {
+        return this->sign ? 1 : -1;
+    }
+    uint8_t buffer[20];
+    size_t length = splitMagnitude(magnitude, buffer);
+    int comparison = compareAbsDigits(this->digits, buffer, length);
+    return this->sign ? comparison : -comparison;
 }
 
 /**
- * @brief Convert to string.
- * 输出为字符串。
+ * @brief Number of characters converted by the chunked Horner scheme before fromString splits the string in two.
+ * fromString 将字符串一分为二之前，由分块 Horner 方法转换的字符数。
+ */
+static const size_t RADIX_LEAF_LENGTH = 256;
+
+/**
+ * @brief Base of the limbs the div_1 passes of toString(base) work on, nine decimal digits per limb.
+ * toString(base) 的 div_1 遍历所使用的limb的基数，每个limb包含九位十进制数字。
+ */
+static const uint64_t RADIX_LIMB_BASE = 1000000000;
+static const size_t RADIX_LIMB_DIGITS = 9;
+
+/**
+ * @brief Bits per character of a power-of-two base.
+ * 二的幂进制中每个字符对应的位数。
  *
- * @return string Output string.输出字符串。
+ * @param base 2, 8, 16 or 32.
+ * @return unsigned
  */
-string BigInt::toString() const
+static unsigned bitsPerCharacter(int base)
 {
-    // Initialize the output result
-    // 初始化输出结果
-    string output = "";
-    // If it is a negative number, add a minus sign to the string
-    // 如果是负数，则在字符串中加上负号
-    if (!this->sign)
-    {
-        output.push_back('-');
-    }
-    // Construct the string
-    // 构建字符串
-    for (auto it = this->digits.rbegin(); it != this->digits.rend(); ++it)
+    switch (base)
     {
-        output.push_back(static_cast<char>('0' + *it));
+    case 2:
+        return 1;
+    case 8:
+        return 3;
+    case 16:
+        return 4;
+    case 32:
+        return 5;
+    default:
+        throw invalid_argument("Unsupported base, expected 2, 8, 10, 16 or 32");
     }
-    return output;
 }
 
 /**
- * @brief Digits getter
+ * @brief Value of one character in a base up to 32 (0-9, then a-v in either case), or -1.
+ * 不超过32进制的单个字符的值（0-9，然后是不区分大小写的 a-v），非法时返回 -1。
  *
- * @return vector<uint8_t>
+ * @param c
+ * @param base
+ * @return int
  */
-vector<uint8_t> BigInt::getDigits() const
+static int characterValue(char c, int base)
 {
-    return this->digits;
+    int value = -1;
+    if (c >= '0' && c <= '9')
+    {
+        value = c - '0';
+    }
+    else if (c >= 'a' && c <= 'z')
+    {
+        value = c - 'a' + 10;
+    }
+    else if (c >= 'A' && c <= 'Z')
+    {
+        value = c - 'A' + 10;
+    }
+    return value < base ? value : -1;
 }
 
 /**
- * @brief Sign getter
+ * @brief Extends the cache of powers factor^(bits * leaf * 2^i) up to and including the given level, by squaring.
+ * With factor 2 these are the powers base^(leaf * 2^i) of the base.
+ * 通过平方把 factor^(bits * leaf * 2^i) 的缓存扩展到给定的层（包含该层）。factor 为2时即为进制的幂 base^(leaf * 2^i)。
  *
- * @return true
- * @return false
+ * @param powers Cache of factor^(bits * leaf * 2^level). factor^(bits * leaf * 2^level) 的缓存。
+ * @param level
+ * @param bits Bits per character of the base. 该进制每个字符的位数。
+ * @param leaf Characters at level 0. 第0层的字符数。
+ * @param factor 2 or 5.
  */
-bool BigInt::getSign() const
+static void buildRadixPowers(vector<BigInt> &powers, size_t level, unsigned bits, size_t leaf, uint64_t factor)
 {
-    return this->sign;
+    while (powers.size() <= level)
+    {
+        // factor^(bits * leaf), built from word-sized powers of factor
+        // factor^(bits * leaf)，由字长以内的 factor 的幂构造
+        if (powers.empty())
+        {
+            BigInt power(1);
+            for (size_t remaining = bits * leaf; remaining > 0;)
+            {
+                uint64_t word = 1;
+                for (; remaining > 0 && word <= (uint64_t(1) << 59) / factor; --remaining)
+                {
+                    word *= factor;
+                }
+                power *= word;
+            }
+            powers.push_back(power);
+        }
+        else
+        {
+            powers.push_back(powers.back() * powers.back());
+        }
+    }
 }
 
 /**
- * @brief + operator, implemented using +=.
- * + 运算符，通过 += 实现。
+ * @brief Converts characters of a power-of-two base. Short strings use Horner's scheme on chunks of
+ * characters that fit in one word (mul_1 and an addition per chunk). Long strings are split so that
+ * value = high * base^lowLength + low, with the powers base^(leaf * 2^level) built once by squaring,
+ * which lets the multiplication tiers do the work.
+ * 转换二的幂进制的字符。短字符串对能放进一个字的字符块使用 Horner 方法（每块一次 mul_1 和一次加法）。
+ * 长字符串拆分为 value = high * base^lowLength + low，幂 base^(leaf * 2^level) 通过平方只计算一次，
+ * 这样主要工作由乘法各层完成。
  *
- * @param lhs
- * @param rhs
- * @return BigInt
+ * @param text Characters, already validated. 已校验的字符。
+ * @param length Number of characters. 字符数。
+ * @param base
+ * @param powers Cache of base^(leaf * 2^level). base^(leaf * 2^level) 的缓存。
+ * @param threads Threads this subtree may use, the high half goes to another thread while more than one is left.
+ * 该子树可以使用的线程数，多于一个时高半部分交给另一个线程。
+ * @return BigInt Absolute value. 绝对值。
  */
-BigInt operator+(BigInt lhs, const BigInt &rhs)
+static BigInt parseRadix(const char *text, size_t length, int base, vector<BigInt> &powers, size_t threads)
 {
-    lhs += rhs;
-    return lhs;
+    unsigned bits = bitsPerCharacter(base);
+    if (length <= RADIX_LEAF_LENGTH)
+    {
+        size_t charactersPerChunk = 59 / bits;
+        BigInt value;
+        for (size_t begin = 0; begin < length; begin += charactersPerChunk)
+        {
+            size_t end = min(length, begin + charactersPerChunk);
+            uint64_t chunk = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                chunk = (chunk << bits) | static_cast<uint64_t>(characterValue(text[i], base));
+            }
+            value *= uint64_t(1) << (bits * (end - begin));
+            value += chunk;
+        }
+        return value;
+    }
+
+    // Largest leaf * 2^level below length
+    // 小于 length 的最大 leaf * 2^level
+    size_t level = 0;
+    size_t lowLength = RADIX_LEAF_LENGTH;
+    while (lowLength * 2 < length)
+    {
+        lowLength *= 2;
+        ++level;
+    }
+    buildRadixPowers(powers, level, bits, RADIX_LEAF_LENGTH, 2);
+    // Both halves need only lower levels, so powers is not modified while they run
+    // 两半都只需要更低的层，因此它们运行期间 powers 不会被修改
+    BigInt high;
+    BigInt low;
+    if (threads > 1)
+    {
+        future<BigInt> highTask = async(launch::async, parseRadix, text, length - lowLength, base, ref(powers), threads / 2);
+        low = parseRadix(text + length - lowLength, lowLength, base, powers, threads - threads / 2);
+        high = highTask.get();
+    }
+    else
+    {
+        high = parseRadix(text, length - lowLength, base, powers, 1);
+        low = parseRadix(text + length - lowLength, lowLength, base, powers, 1);
+    }
+    addmul(low, high, powers[level]);
+    return low;
 }
 
 /**
- * @brief - operator, implemented using -=.
- * - 运算符，通过 -= 实现。
+ * @brief Initializes from a string in base 2, 8, 10, 16 or 32, with an optional sign.
+ * Digits above 9 are a-v in either case. Power-of-two bases are converted without going through decimal text.
+ * 从2、8、10、16或32进制的字符串初始化，可以带符号。
+ * 大于9的数字为不区分大小写的 a-v。二的幂进制不经过十进制文本直接转换。
  *
- * @param lhs
- * @param rhs
+ * @param value The string to convert. 要转换的字符串。
+ * @param base
  * @return BigInt
  */
-BigInt operator-(BigInt lhs, const BigInt &rhs)
+BigInt BigInt::fromString(const string &value, int base)
 {
-    lhs -= rhs;
-    return lhs;
+    // Reject unsupported bases before looking at the digits
+    // 在检查数字之前拒绝不支持的进制
+    if (base != 10)
+    {
+        bitsPerCharacter(base);
+    }
+    size_t start = (!value.empty() && (value[0] == '-' || value[0] == '+')) ? 1 : 0;
+    if (start == value.size())
+    {
+        throw runtime_error("Empty number");
+    }
+    for (size_t i = start; i < value.size(); ++i)
+    {
+        if (characterValue(value[i], base) < 0)
+        {
+            throw runtime_error("Invalid digit for base " + to_string(base));
+        }
+    }
+    BigInt result;
+    if (base == 10)
+    {
+        result = BigInt(value);
+    }
+    else
+    {
+        vector<BigInt> powers;
+        size_t length = value.size() - start;
+        result = parseRadix(value.data() + start, length, base, powers, conversionThreadCount(length));
+        result.sign = (value[0] != '-');
+    }
+    result.normalize();
+    return result;
 }
 
 /**
- * @brief * operator, implemented using *=.
- * * 运算符，通过 *= 实现。
+ * @brief Appends the characters of a non-negative value below base^(leaf * 2^level), most significant first.
+ * Values of at least radixSplitThreshold digits are split as high * 2^k + low, where 2^k = base^(leaf * 2^(level - 1)),
+ * and both halves are converted recursively. Since 2^k * 5^k = 10^k, high is value * 5^k with its k lowest decimal
+ * digits dropped, and low = value - high * 2^k, so a split costs two multiplications and no division. Smaller values
+ * regroup their digits into limbs of nine and use div_1 by 2^32 (a shift and a mask per limb), each pass producing a
+ * chunk of characters.
+ * 按从高到低的顺序追加小于 base^(leaf * 2^level) 的非负值的字符。
+ * 不少于 radixSplitThreshold 位的值拆分为 high * 2^k + low，其中 2^k = base^(leaf * 2^(level - 1))，并递归转换两半。
+ * 由于 2^k * 5^k = 10^k，high 就是 value * 5^k 去掉最低 k 位十进制数字，而 low = value - high * 2^k，
+ * 因此一次拆分只需两次乘法而不需要除法。较小的值将数字每九位组合为一个limb，并对 2^32 使用 div_1
+ * （每个limb一次移位和一次掩码），每次遍历得到一块字符。
  *
- * @param lhs
- * @param rhs
- * @return BigInt
+ * @param value Non-negative value. 非负值。
+ * @param level
+ * @param base
+ * @param leaf Characters at level 0, chosen by toString so that the first split is balanced.
+ * 第0层的字符数，由 toString 选择，使第一次拆分均衡。
+ * @param powers Cache of 2^k = base^(leaf * 2^level), built up to level - 1. 2^k = base^(leaf * 2^level) 的缓存，已构造到 level - 1 层。
+ * @param fivePowers The matching powers 5^k, built up to level - 1. 对应的幂 5^k，已构造到 level - 1 层。
+ * @param pad Whether to zero-pad to exactly leaf * 2^level characters, true for every low half.
+ * 是否补零到正好 leaf * 2^level 个字符，所有低半部分都为 true。
+ * @param out
+ * @param threads Threads this subtree may use, the high half goes to another thread while more than one is left.
+ * 该子树可以使用的线程数，多于一个时高半部分交给另一个线程。
  */
-BigInt operator*(BigInt lhs, const BigInt &rhs)
+void BigInt::formatRadix(const BigInt &value, size_t level, int base, size_t leaf, const vector<BigInt> &powers, const vector<BigInt> &fivePowers, bool pad, string &out, size_t threads)
 {
-    lhs *= rhs;
-    return lhs;
+    if (level > 0 && value.digits.size() >= BigInt::getTuning().radixSplitThreshold)
+    {
+        const BigInt &power = powers[level - 1];
+        if (!pad && value < power)
+        {
+            // An unpadded high half has no leading zeros to emit
+            // 不补零的高半部分没有需要输出的前导零
+            formatRadix(value, level - 1, base, leaf, powers, fivePowers, false, out, threads);
+            return;
+        }
+        // high = floor(value / 2^k) = floor(value * 5^k / 10^k). Dropping the lowest 0.3k digits of value
+        // (10^j <= 2^k) and the lowest 0.39k digits of 5^k (10^i <= 2.5^k, and value < 4^k) lowers the product by
+        // less than 2 * 10^k, so the estimate is at most 2 below high and both products are about half the length
+        // high = floor(value / 2^k) = floor(value * 5^k / 10^k)。去掉 value 最低的 0.3k 位（10^j <= 2^k）
+        // 和 5^k 最低的 0.39k 位（10^i <= 2.5^k，且 value < 4^k）使乘积减小不到 2 * 10^k，
+        // 因此估计值至多比 high 小2，且两次乘法的长度都约为一半
+        size_t shift = bitsPerCharacter(base) * (leaf << (level - 1));
+        size_t valueDrop = shift * 3 / 10;
+        size_t fiveDrop = shift * 39 / 100;
+        DigitVector estimate = productDigits(shiftDownDigits(value.digits, valueDrop), shiftDownDigits(fivePowers[level - 1].digits, fiveDrop));
+        BigInt high;
+        high.digits.overwrite() = shiftDownDigits(estimate, shift - valueDrop - fiveDrop);
+        BigInt low = value - high * power;
+        while (low >= power)
+        {
+            low -= power;
+            high += 1;
+        }
+        // Both halves only read the powers, so the high half can run on another thread while more than one is left.
+        // The cancellation scope belongs to the calling thread, so that thread installs the same token again
+        // 两半都只读取幂，因此多于一个线程时高半部分可以在另一个线程上运行。
+        // 取消作用域属于调用线程，因此该线程重新安装同一个令牌
+        if (threads > 1)
+        {
+            const BigIntCancelToken *token = BigIntCancelScope::current();
+            string highOut;
+            future<void> highTask = async(launch::async, [&, token]()
+                                          {
+                if (token == nullptr)
+                {
+                    formatRadix(high, level - 1, base, leaf, powers, fivePowers, pad, highOut, threads / 2);
+                    return;
+                }
+                BigIntCancelScope scope(*token);
+                formatRadix(high, level - 1, base, leaf, powers, fivePowers, pad, highOut, threads / 2); });
+            string lowOut;
+            formatRadix(low, level - 1, base, leaf, powers, fivePowers, true, lowOut, threads - threads / 2);
+            highTask.get();
+            out += highOut;
+            out += lowOut;
+        }
+        else
+        {
+            formatRadix(high, level - 1, base, leaf, powers, fivePowers, pad, out, 1);
+            formatRadix(low, level - 1, base, leaf, powers, fivePowers, true, out, 1);
+        }
+        return;
+    }
+
+    // Regroup the digits into limbs of nine, so one pass handles nine digits per step. A chunk of at most 32 bits
+    // keeps remainder * 10^9 + limb within 64 bits, and dividing by a power of two is a shift and a mask
+    // 将数字每九位重新组合为一个limb，使每次遍历每步处理九位。块不超过32位时 remainder * 10^9 + limb 不超过64位，
+    // 且除以二的幂只需移位和掩码
+    const DigitVector &digits = value.digits;
+    vector<uint32_t> limbs((digits.size() + RADIX_LIMB_DIGITS - 1) / RADIX_LIMB_DIGITS, 0);
+    for (size_t i = digits.size(); i-- > 0;)
+    {
+        limbs[i / RADIX_LIMB_DIGITS] = limbs[i / RADIX_LIMB_DIGITS] * 10 + digits[i];
+    }
+    unsigned bits = bitsPerCharacter(base);
+    size_t charactersPerChunk = 32 / bits;
+    unsigned chunkBits = static_cast<unsigned>(bits * charactersPerChunk);
+    uint64_t chunkMask = (uint64_t(1) << chunkBits) - 1;
+    const char *alphabet = "0123456789abcdefghijklmnopqrstuv";
+
+    // Characters are produced from the least significant one
+    // 字符从最低位开始生成
+    string reversed;
+    while (!limbs.empty() && limbs.back() == 0)
+    {
+        limbs.pop_back();
+    }
+    while (!limbs.empty())
+    {
+        BigIntCancelScope::checkpoint();
+        uint64_t chunk = 0;
+        for (size_t i = limbs.size(); i-- > 0;)
+        {
+            uint64_t current = chunk * RADIX_LIMB_BASE + limbs[i];
+            limbs[i] = static_cast<uint32_t>(current >> chunkBits);
+            chunk = current & chunkMask;
+        }
+        while (!limbs.empty() && limbs.back() == 0)
+        {
+            limbs.pop_back();
+        }
+        for (size_t i = 0; i < charactersPerChunk; ++i)
+        {
+            reversed.push_back(alphabet[chunk & ((uint64_t(1) << bits) - 1)]);
+            chunk >>= bits;
+        }
+    }
+    // Remove leading zeros, or pad to the full width of the level
+    // 删除前导零，或补零到该层的完整宽度
+    size_t width = pad ? leaf << level : 1;
+    while (reversed.size() > width && reversed.back() == '0')
+    {
+        reversed.pop_back();
+    }
+    reversed.resize(max(reversed.size(), width), '0');
+    out.append(reversed.rbegin(), reversed.rend());
 }
 
 /**
- * @brief Utility function to compare absolute values.
- * Only called in case of different signs, so no need to consider the same sign.
- * 工具函数，比较绝对值大小。
- * 只会在两数异号的情况下调用，所以不需要考虑两数同号的情况。
+ * @brief Converts to a string in base 2, 8, 10, 16 or 32, digits above 9 are lowercase.
+ * Splits the value by divide-and-conquer on the powers base^(leaf * 2^level), mirroring fromString.
+ * 转换为2、8、10、16或32进制的字符串，大于9的数字为小写。
+ * 与 fromString 对称，按幂 base^(leaf * 2^level) 分治拆分数值。
  *
- * @param lhs
- * @param rhs
- * @return true
- * @return false
+ * @param base
+ * @return string
  */
-bool BigInt::isAbsGreaterOrEqual(const BigInt &lhs, const BigInt &rhs)
+string BigInt::toString(int base) const
 {
-    // Get absolute value, then compare
-    // 先把两个数取绝对值，再比较绝对值大小
-    if (lhs.sign)
+    if (base == 10)
     {
-        return lhs >= -rhs;
+        return toString();
     }
-    else
+    unsigned bits = bitsPerCharacter(base);
+    BigInt magnitude = *this;
+    magnitude.sign = true;
+
+    // The magnitude has at most ceil(digits * log2(10) / bits) characters. The smallest level whose 256 * 2^level
+    // characters cover them, with the leaf shrunk to just cover them, makes the first split fall at half the value
+    // magnitude 至多有 ceil(digits * log2(10) / bits) 个字符。取 256 * 2^level 个字符能覆盖它们的最小层，
+    // 再把叶子缩小到刚好覆盖，使第一次拆分落在该值的一半处
+    vector<BigInt> powers;
+    vector<BigInt> fivePowers;
+    size_t level = 0;
+    size_t leaf = RADIX_LEAF_LENGTH;
+    if (magnitude.digits.size() >= BigInt::getTuning().radixSplitThreshold)
     {
-        return -lhs >= rhs;
+        size_t characters = (magnitude.digits.size() * 33220 / 10000 + bits) / bits;
+        while ((RADIX_LEAF_LENGTH << level) < characters)
+        {
+            ++level;
+        }
+        leaf = (characters + (size_t(1) << level) - 1) >> level;
+        if (level > 0)
+        {
+            buildRadixPowers(powers, level - 1, bits, leaf, 2);
+            buildRadixPowers(fivePowers, level - 1, bits, leaf, 5);
+        }
     }
+    string result = this->sign ? "" : "-";
+    formatRadix(magnitude, level, base, leaf, powers, fivePowers, false, result, conversionThreadCount(magnitude.digits.size()));
+    return result;
 }
 
 /**
- * @brief Utility function to subtract the smaller absolute value BigInt from the larger one.
- * 工具函数，从绝对值大的 BigInt 中减去绝对值小的 BigInt。
+ * @brief Compiled-in default thresholds, used when there is no tuning profile.
+ * 编译时内置的默认阈值，没有调优配置文件时使用。
  *
- * @param rhs
+ * @return BigIntTuning
  */
-void BigInt::subtractAbs(const BigInt &rhs)
+BigIntTuning BigInt::defaultTuning()
 {
-    bool borrow = false;
-    for (size_t i = 0; i < this->digits.size(); ++i)
+    BigIntTuning tuning;
+    tuning.karatsubaThreshold = 32;
+    tuning.parallelConversionThreshold = 1 << 20;
+    tuning.radixSplitThreshold = 1 << 26;
+    tuning.conversionThreads = 0;
+    tuning.rationalReduceThreshold = 256;
+    tuning.growthPercent = 25;
+    tuning.shrinkFactor = 4;
+    tuning.shrinkMinimum = 4096;
+    return tuning;
+}
+
+/**
+ * @brief Thresholds currently in use.
+ * 当前使用的阈值。
+ *
+ * @return const BigIntTuning&
+ */
+const BigIntTuning &BigInt::getTuning()
+{
+    return tuningStorage();
+}
+
+/**
+ * @brief Replace the thresholds currently in use. Not thread-safe, call it before starting any computation.
+ * 替换当前使用的阈值。非线程安全，需要在开始任何计算之前调用。
+ *
+ * @param tuning
+ */
+void BigInt::setTuning(const BigIntTuning &tuning)
+{
+    tuningStorage() = tuning;
+}
+
+/**
+ * @brief Read a tuning profile. Each line is "key value", lines starting with '#' are comments.
+ * Keys missing from the profile keep the value they already have in tuning.
+ * 读取调优配置文件。每行格式为 "key value"，以 '#' 开头的行为注释。
+ * 配置文件中没有的键保留 tuning 中原有的值。
+ *
+ * @param path Path of the profile. 配置文件路径。
+ * @param tuning Receives the thresholds. 接收读取的阈值。
+ * @return true The profile was read. 成功读取。
+ * @return false The profile could not be opened or is malformed. 无法打开或格式错误。
+ */
+bool BigInt::loadTuning(const string &path, BigIntTuning &tuning)
+{
+    ifstream file(path);
+    if (!file)
     {
-        int subtraction = int(this->digits[i]) - (i < rhs.digits.size() ? int(rhs.digits[i]) : 0) - borrow;
-        borrow = subtraction < 0;
-        if (borrow)
+        return false;
+    }
+    string line;
+    while (getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
         {
-            subtraction += 10;
+            continue;
+        }
+        stringstream ss(line);
+        string key;
+        size_t value;
+        if (!(ss >> key >> value))
+        {
+            return false;
+        }
+        if (key == "karatsuba_threshold")
+        {
+            tuning.karatsubaThreshold = value;
+        }
+        else if (key == "parallel_conversion_threshold")
+        {
+            tuning.parallelConversionThreshold = value;
+        }
+        else if (key == "radix_split_threshold")
+        {
+            tuning.radixSplitThreshold = value;
+        }
+        else if (key == "conversion_threads")
+        {
+            tuning.conversionThreads = value;
+        }
+        else if (key == "rational_reduce_threshold")
+        {
+            tuning.rationalReduceThreshold = value;
+        }
+        else if (key == "growth_percent")
+        {
+            tuning.growthPercent = value;
+        }
+        else if (key == "shrink_factor")
+        {
+            tuning.shrinkFactor = value;
+        }
+        else if (key == "shrink_minimum")
+        {
+            tuning.shrinkMinimum = value;
         }
-        this->digits[i] = static_cast<uint8_t>(subtraction);
     }
+    return true;
+}
 
-    // Remove leading zeros from the result
-    // 删除结果中的前导零
-    while (this->digits.size() > 1 && this->digits.back() == 0)
+/**
+ * @brief Write a tuning profile that loadTuning can read.
+ * 写入 loadTuning 可以读取的调优配置文件。
+ *
+ * @param path Path of the profile. 配置文件路径。
+ * @param tuning Thresholds to write. 要写入的阈值。
+ * @return true The profile was written. 成功写入。
+ * @return false The profile could not be written. 无法写入。
+ */
+bool BigInt::saveTuning(const string &path, const BigIntTuning &tuning)
+{
+    ofstream file(path);
+    if (!file)
     {
-        this->digits.pop_back();
+        return false;
     }
+    file << "# BigInt tuning profile, generated by tune" << '\n';
+    file << "karatsuba_threshold " << tuning.karatsubaThreshold << '\n';
+    file << "parallel_conversion_threshold " << tuning.parallelConversionThreshold << '\n';
+    file << "radix_split_threshold " << tuning.radixSplitThreshold << '\n';
+    file << "conversion_threads " << tuning.conversionThreads << '\n';
+    file << "rational_reduce_threshold " << tuning.rationalReduceThreshold << '\n';
+    file << "growth_percent " << tuning.growthPercent << '\n';
+    file << "shrink_factor " << tuning.shrinkFactor << '\n';
+    file << "shrink_minimum " << tuning.shrinkMinimum << '\n';
+    return static_cast<bool>(file);
 }
@@ -1,3 +1,5 @@
+#pragma once
+
 using namespace std;
 
 #include <vector>
@@ -5,6 +7,294 @@ using namespace std;
 #include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <memory>
+#include <cstdio>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <future>
+
+// Thrown by a kernel that finds its operation cancelled or past its deadline 内核发现运算已取消或超过截止时间时抛出
+class BigIntCancelled : public runtime_error
+{
+public:
+    explicit BigIntCancelled(const string &reason);
+};
+
+// Cooperative cancellation, deadline and progress of a long-running operation. Copies share one state,
+// so the caller keeps a copy to cancel the work or read its progress
+// 长时间运算的协作式取消、截止时间和进度。副本共享同一状态，调用者保留一个副本即可取消运算或读取进度
+class BigIntCancelToken
+{
+public:
+    // Not cancelled, no deadline, no progress 未取消，无截止时间，无进度
+    BigIntCancelToken();
+    // Requests cancellation 请求取消
+    void cancel() const;
+    // Operations still running after the deadline are cancelled 截止时间之后仍在运行的运算将被取消
+    void setDeadline(chrono::steady_clock::time_point deadline) const;
+    // Cancelled or past the deadline 已取消或已超过截止时间
+    bool expired() const;
+    // Throws BigIntCancelled when expired 过期时抛出 BigIntCancelled
+    void check() const;
+    // Fraction of the work done, from 0 to 1 已完成的工作比例，从0到1
+    double progress() const;
+    void setProgress(double fraction) const;
+
+private:
+    struct State
+    {
+        atomic<bool> cancelled;
+        atomic<int64_t> deadlineNs;
+        atomic<double> progress;
+    };
+    shared_ptr<State> state;
+};
+
+// Makes a token the one checked by the kernels running on this thread, until the scope ends
+// 在作用域结束之前，使该令牌成为本线程上运行的内核所检查的令牌
+class BigIntCancelScope
+{
+public:
+    explicit BigIntCancelScope(const BigIntCancelToken &token);
+    ~BigIntCancelScope();
+    BigIntCancelScope(const BigIntCancelScope &) = delete;
+    BigIntCancelScope &operator=(const BigIntCancelScope &) = delete;
+    // Token of the innermost scope on this thread, null outside any scope 本线程最内层作用域的令牌，不在任何作用域内时为空
+    static const BigIntCancelToken *current();
+    // Safe point for long loops outside the multiplication kernels, checks the token of the innermost scope if any
+    // 乘法内核之外的长循环的安全点，如有最内层作用域的令牌则检查它
+    static void checkpoint();
+
+private:
+    const BigIntCancelToken *previous;
+};
+
+// Crossover thresholds between the multiplication tiers 乘法各层算法之间的切换阈值
+struct BigIntTuning
+{
+    // Operands with at least this many digits are multiplied with Karatsuba instead of schoolbook multiplication
+    // 位数不少于该值的操作数使用 Karatsuba 乘法，而不是手算乘法
+    size_t karatsubaThreshold;
+    // Decimal and radix conversions of at least this many digits are split across threads
+    // 位数不少于该值的十进制和进制转换拆分到多个线程执行
+    size_t parallelConversionThreshold;
+    // toString(base) splits values with at least this many digits in two, with two multiplications, instead of running div_1 passes
+    // toString(base) 将位数不少于该值的数用两次乘法一分为二，而不是执行 div_1 遍历
+    size_t radixSplitThreshold;
+    // Number of threads used by parallel conversions, 0 for one per hardware thread
+    // 并行转换使用的线程数，0 表示每个硬件线程一个
+    size_t conversionThreads;
+    // BigRational reduces a result whose numerator and denominator together have more digits than this
+    // BigRational 在结果的分子与分母合计位数超过该值时约分
+    size_t rationalReduceThreshold;
+    // Extra capacity, in percent of the needed length, reserved when the digits grow in place. 0 grows exactly
+    // 数字原地增长时额外预留的容量，为所需长度的百分比。0 表示精确增长
+    size_t growthPercent;
+    // normalize() releases the spare capacity when it is more than shrinkFactor times the length and at least
+    // shrinkMinimum digits. 0 disables shrinking
+    // 空闲容量超过长度的 shrinkFactor 倍且至少为 shrinkMinimum 位时，normalize() 释放空闲容量。0 表示不收缩
+    size_t shrinkFactor;
+    size_t shrinkMinimum;
+};
+
+// Bytes currently allocated by all digit buffers 所有数字缓冲区当前分配的字节数
+atomic<size_t> &liveDigitBytes();
+
+// Allocator of the digit buffers, counts the bytes it hands out in liveDigitBytes() 数字缓冲区的分配器，在 liveDigitBytes() 中统计分配的字节数
+template <typename T>
+class DigitAllocator
+{
+public:
+    using value_type = T;
+    DigitAllocator() = default;
+    template <typename U>
+    DigitAllocator(const DigitAllocator<U> &)
+    {
+    }
+    T *allocate(size_t count)
+    {
+        T *pointer = allocator<T>().allocate(count);
+        liveDigitBytes().fetch_add(count * sizeof(T), memory_order_relaxed);
+        return pointer;
+    }
+    void deallocate(T *pointer, size_t count)
+    {
+        liveDigitBytes().fetch_sub(count * sizeof(T), memory_order_relaxed);
+        allocator<T>().deallocate(pointer, count);
+    }
+    // Stateless, any instance frees what another allocated 无状态，任一实例都可以释放另一实例分配的内存
+    template <typename U>
+    bool operator==(const DigitAllocator<U> &) const
+    {
+        return true;
+    }
+    template <typename U>
+    bool operator!=(const DigitAllocator<U> &) const
+    {
+        return false;
+    }
+};
+
+// Vector of decimal digits 十进制数字的向量
+using DigitVector = vector<uint8_t, DigitAllocator<uint8_t>>;
+
+// Digit storage of BigInt. With BIGINT_COPY_ON_WRITE defined, copies share one reference-counted buffer,
+// and a mutation detaches (copies the digits) only when the buffer is shared. Without it, this is a plain DigitVector.
+// BigInt 的数字存储。定义 BIGINT_COPY_ON_WRITE 时，拷贝共享同一个引用计数的缓冲区，
+// 只有在缓冲区被共享时，修改操作才会分离（拷贝数字）。未定义时就是普通的 DigitVector。
+class DigitBuffer
+{
+public:
+    // Read access, never detaches 只读访问，不会分离
+    const DigitVector &read() const
+    {
+#ifdef BIGINT_COPY_ON_WRITE
+        return this->buffer ? *this->buffer : emptyBuffer();
+#else
+        return this->buffer;
+#endif
+    }
+    // Write access, keeps the digits and detaches first if the buffer is shared 写访问，保留数字，缓冲区被共享时先分离
+    DigitVector &write()
+    {
+#ifdef BIGINT_COPY_ON_WRITE
+        if (!this->buffer)
+        {
+            this->buffer = make_shared<DigitVector>();
+        }
+        else if (this->buffer.use_count() > 1)
+        {
+            this->buffer = make_shared<DigitVector>(*this->buffer);
+        }
+        return *this->buffer;
+#else
+        return this->buffer;
+#endif
+    }
+    // Write access for replacing all digits, a shared buffer is dropped instead of copied 用于替换全部数字的写访问，被共享的缓冲区直接丢弃而不拷贝
+    DigitVector &overwrite()
+    {
+#ifdef BIGINT_COPY_ON_WRITE
+        if (!this->buffer || this->buffer.use_count() > 1)
+        {
+            this->buffer = make_shared<DigitVector>();
+        }
+        return *this->buffer;
+#else
+        return this->buffer;
+#endif
+    }
+    operator const DigitVector &() const
+    {
+        return read();
+    }
+
+    // vector-like interface, const members read and the others write vector 风格的接口，const 成员只读，其余为写访问
+    size_t size() const
+    {
+        return read().size();
+    }
+    const uint8_t *data() const
+    {
+        return read().data();
+    }
+    uint8_t operator[](size_t index) const
+    {
+        return read()[index];
+    }
+    uint8_t &operator[](size_t index)
+    {
+        return write()[index];
+    }
+    uint8_t back() const
+    {
+        return read().back();
+    }
+    DigitVector::const_iterator begin() const
+    {
+        return read().begin();
+    }
+    DigitVector::const_iterator end() const
+    {
+        return read().end();
+    }
+    DigitVector::const_reverse_iterator rbegin() const
+    {
+        return read().rbegin();
+    }
+    DigitVector::const_reverse_iterator rend() const
+    {
+        return read().rend();
+    }
+    void push_back(uint8_t digit)
+    {
+        write().push_back(digit);
+    }
+    void pop_back()
+    {
+        write().pop_back();
+    }
+    void resize(size_t length, uint8_t digit)
+    {
+        write().resize(length, digit);
+    }
+    void clear()
+    {
+        overwrite().clear();
+    }
+    void assign(size_t length, uint8_t digit)
+    {
+        overwrite().assign(length, digit);
+    }
+    template <typename Iterator>
+    void assign(Iterator first, Iterator last)
+    {
+        overwrite().assign(first, last);
+    }
+    size_t capacity() const
+    {
+        return read().capacity();
+    }
+    void reserve(size_t length)
+    {
+        write().reserve(length);
+    }
+    // Releases the spare capacity, a shared buffer is left alone 释放空闲容量，被共享的缓冲区保持不变
+    void shrinkToFit()
+    {
+#ifdef BIGINT_COPY_ON_WRITE
+        if (!this->buffer || this->buffer.use_count() > 1)
+        {
+            return;
+        }
+#endif
+        write().shrink_to_fit();
+    }
+    void swap(DigitBuffer &other)
+    {
+        this->buffer.swap(other.buffer);
+    }
+    // Exchanges the digits with a digit vector 与数字向量交换
+    void swap(DigitVector &other)
+    {
+        overwrite().swap(other);
+    }
+
+private:
+#ifdef BIGINT_COPY_ON_WRITE
+    shared_ptr<DigitVector> buffer;
+    // Read by moved-from buffers 被移动后的缓冲区读取时使用
+    static const DigitVector &emptyBuffer()
+    {
+        static const DigitVector empty;
+        return empty;
+    }
+#else
+    DigitVector buffer;
+#endif
+};
 
 class BigInt
 {
@@ -20,15 +310,34 @@ public:
     // Copy constructor and assignment operators拷贝构造函数和赋值运算符
     // Copy constructor 拷贝构造函数
     BigInt(const BigInt &other);
+    // Move constructor 移动构造函数
+    BigInt(BigInt &&other) noexcept;
     // Assignment operator赋值运算符
     BigInt &operator=(const string &value); 
     BigInt &operator=(int64_t value);
     BigInt &operator=(const BigInt &other);
+    BigInt &operator=(BigInt &&other) noexcept;
 
     // Compound assignment operators 复合赋值运算符
     BigInt &operator+=(const BigInt &rhs);
     BigInt &operator-=(const BigInt &rhs);
     BigInt &operator*=(const BigInt &rhs);
+    // Truncating long division, the remainder has the sign of the dividend 截断长除法，余数与被除数同号
+    BigInt &operator/=(const BigInt &rhs);
+    BigInt &operator%=(const BigInt &rhs);
+
+    // Compound assignment with a built-in integer, no temporary BigInt is constructed 与内置整数的复合赋值，不构造临时 BigInt
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    BigInt &operator+=(T rhs);
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    BigInt &operator-=(T rhs);
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    BigInt &operator*=(T rhs);
+    // Truncating division, the remainder has the sign of the dividend 截断除法，余数与被除数同号
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    BigInt &operator/=(T rhs);
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    BigInt &operator%=(T rhs);
 
     // Unary operator 一元运算符
     // Negation operator 负号运算符，改变数的符号
@@ -42,31 +351,369 @@ public:
     bool operator<=(const BigInt &rhs) const;
     bool operator>=(const BigInt &rhs) const;
 
+    // Comparison with a built-in integer 与内置整数比较
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    bool operator==(T rhs) const;
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    bool operator!=(T rhs) const;
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    bool operator<(T rhs) const;
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    bool operator>(T rhs) const;
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    bool operator<=(T rhs) const;
+    template <typename T, typename = enable_if_t<is_integral<T>::value>>
+    bool operator>=(T rhs) const;
+
     // Insertion operator 输入输出运算符
     friend std::ostream &operator<<(std::ostream &os, const BigInt &num);
 
+    // Output-parameter arithmetic, reuses the capacity of dst, dst may alias a or b 输出参数形式的算术运算，复用 dst 的容量，dst 可以与 a 或 b 相同
+    friend void add(BigInt &dst, const BigInt &a, const BigInt &b);
+    friend void sub(BigInt &dst, const BigInt &a, const BigInt &b);
+    friend void mul(BigInt &dst, const BigInt &a, const BigInt &b);
+    // Fused multiply-add, dst += a * b and dst -= a * b in one pass over dst without a temporary product
+    // 融合乘加，一次遍历 dst 完成 dst += a * b 和 dst -= a * b，不产生临时乘积
+    friend void addmul(BigInt &dst, const BigInt &a, const BigInt &b);
+    friend void submul(BigInt &dst, const BigInt &a, const BigInt &b);
+    // Greatest common divisor of the absolute values, gcd(0, 0) is 0 绝对值的最大公约数，gcd(0, 0) 为0
+    friend BigInt gcd(const BigInt &a, const BigInt &b);
+
+    // Asynchronous multiplication on another thread. The kernels check token at safe points and report
+    // progress to it, a cancelled or expired operation makes the future throw BigIntCancelled
+    // 在另一个线程上异步相乘。内核在安全点检查 token 并向其报告进度，运算被取消或过期时 future 抛出 BigIntCancelled
+    static future<BigInt> asyncMul(const BigInt &a, const BigInt &b, const BigIntCancelToken &token = BigIntCancelToken());
+
     // Other auxiliary methods 其他辅助方法
     // Returns the length of the number (number of digits) 返回数字的长度（位数）
     size_t size() const;  
     // Converts BigInt to a string 将 BigInt 转换为字符串             
     string toString() const;  
+    // Writes the decimal digits in bounded chunks without building the whole string, returns false on a write error
+    // 分块写出十进制数字而不构建完整字符串，写入出错时返回 false
+    bool writeTo(ostream &os) const;
+    bool writeTo(FILE *file) const;
+    bool writeTo(int fd) const;
+    // Converts to a string in base 2, 8, 10, 16 or 32 转换为2、8、10、16或32进制的字符串
+    string toString(int base) const;
+    // Initializes from a string in base 2, 8, 10, 16 or 32 从2、8、10、16或32进制的字符串初始化
+    static BigInt fromString(const string &value, int base);
     // Digits getter
     vector<uint8_t> getDigits() const; 
     // Sign getter
     bool getSign() const; 
+    // Hash of the sign and digits, used by std::hash<BigInt> 符号和数字的哈希值，供 std::hash<BigInt> 使用
+    size_t hash() const;
+
+    // Memory 内存
+    // Makes room for at least length digits 预留至少 length 位数字的空间
+    void reserve(size_t length);
+    // Releases the spare capacity of the digits 释放数字的空闲容量
+    void shrinkToFit();
+    // Heap bytes held by the digits, shared by copies with copy-on-write digits 数字占用的堆内存字节数，使用写时复制时由拷贝共享
+    size_t memoryUsage() const;
+    // Heap bytes held by the digit buffers of all live BigInts 所有存活的 BigInt 的数字缓冲区占用的堆内存字节数
+    static size_t liveBytes();
+
+    // Primality 素性测试
+    // Trial division by small primes, then rounds of Miller-Rabin 先用小素数试除，再进行 rounds 轮 Miller-Rabin 测试
+    bool isProbablePrime(int rounds = 25) const;
+    // Smallest probable prime greater than this value 大于该值的最小可能素数
+    BigInt nextPrime(int rounds = 25) const;
+
+    // Tuning profile 调优配置
+    // Compiled-in default thresholds 编译时内置的默认阈值
+    static BigIntTuning defaultTuning();
+    // Thresholds currently in use (loaded from the tuning profile on first use) 当前使用的阈值（首次使用时从调优配置文件加载）
+    static const BigIntTuning &getTuning();
+    // Replace the thresholds currently in use 替换当前使用的阈值
+    static void setTuning(const BigIntTuning &tuning);
+    // Read a tuning profile, returns false if the file cannot be read 读取调优配置文件，无法读取时返回 false
+    static bool loadTuning(const string &path, BigIntTuning &tuning);
+    // Write a tuning profile, returns false if the file cannot be written 写入调优配置文件，无法写入时返回 false
+    static bool saveTuning(const string &path, const BigIntTuning &tuning);
 
 private:
+    // Builds the value from digits prepared at compile time 由编译时准备好的数字构造值
+    template <char... Chars>
+    friend BigInt operator""_big();
+    // Builds a BigInt from little-endian digits 由小端存储的数字构造 BigInt
+    static BigInt fromDigits(const uint8_t *digits, size_t length, bool positive);
+    // Stores the digits of a decimal string, shared by the string constructor and assignment 存储十进制字符串的数字，供字符串构造函数和赋值共用
+    void assignDecimal(const string &value);
+
+    // Reads the digits directly 直接读取数字
+    friend class BigIntAccumulator;
+    friend class BigIntBatch;
+    friend class BigIntView;
+    // Converts the digits into a fixed buffer and hands each full chunk to sink 将数字转换到固定缓冲区中，并把每个写满的块交给 sink
+    bool writeChunks(const function<bool(const char *, size_t)> &sink) const;
+    friend size_t serializedSize(const BigInt &value);
+    friend void serialize(const BigInt &value, vector<uint8_t> &out);
+
     // Sign of the integer数的符号
     bool sign;   
     // Stores each digit of the integer存储数字的每一位                
-    vector<uint8_t> digits; 
+    DigitBuffer digits; 
     // Comparation of the absolute values绝对值比较
     bool isAbsGreaterOrEqual(const BigInt &lhs, const BigInt &rhs); 
     // Subtracts the smaller absolute value BigInt from the larger absolute value BigInt 从绝对值大的 BigInt 中减去绝对值小的 BigInt
     void subtractAbs(const BigInt &rhs);                            
+    // Replaces the absolute value with |rhs| - |this| 将绝对值替换为 |rhs| - |this|
+    void reverseSubtractAbs(const BigInt &rhs);
+    // Adds rhs with the given sign 以给定符号加上 rhs
+    void addSigned(const BigInt &rhs, bool rhsSign);
+    // Removes leading zeros and makes the sign of 0 positive 删除前导零并把0的符号设为正
+    void normalize();
+
+    // Single-word kernels, the scalar is given as absolute value and sign 单字内核，标量以绝对值和符号的形式给出
+    // Absolute value of a built-in integer 内置整数的绝对值
+    template <typename T>
+    static uint64_t scalarMagnitude(T value);
+    // Sign of a built-in integer (true for non-negative) 内置整数的符号（非负为 true）
+    template <typename T>
+    static bool scalarSign(T value);
+    // Builds a BigInt from an absolute value and a sign 由绝对值和符号构造 BigInt
+    static BigInt fromMagnitude(uint64_t magnitude, bool positive);
+    void addScalar(uint64_t magnitude, bool positive);
+    // mul_1: one linear pass 一次线性遍历
+    void mulScalar(uint64_t magnitude, bool positive);
+    // div_1: one linear pass, keeps the quotient or the remainder 一次线性遍历，保留商或余数
+    void divScalar(uint64_t magnitude, bool positive, bool keepRemainder);
+    // The div_1 pass on the absolute value, returns the remainder div_1 对绝对值的遍历，返回余数
+    uint64_t divideAbs(uint64_t magnitude, bool storeQuotient);
+    // Returns -1, 0 or 1 返回 -1、0 或 1
+    int compareScalar(uint64_t magnitude, bool positive) const;
+    // Long division by a BigInt, keeps the quotient or the remainder 除以 BigInt 的长除法，保留商或余数
+    void divLong(const BigInt &rhs, bool keepRemainder);
+    // Shared by addmul and submul 供 addmul 和 submul 共用
+    void multiplyAdd(const BigInt &a, const BigInt &b, bool subtract);
+    // Divide-and-conquer step of toString(base), appends the characters of a non-negative value
+    // toString(base) 的分治步骤，追加非负值的字符
+    static void formatRadix(const BigInt &value, size_t level, int base, size_t leaf, const vector<BigInt> &powers, const vector<BigInt> &fivePowers, bool pad, string &out, size_t threads);
 };
 
 // Arithmetic operators 算术运算符
 BigInt operator+(BigInt lhs, const BigInt &rhs); 
 BigInt operator-(BigInt lhs, const BigInt &rhs); 
-BigInt operator*(BigInt lhs, const BigInt &rhs); 
\ No newline at end of file
+BigInt operator*(BigInt lhs, const BigInt &rhs);
+BigInt operator/(BigInt lhs, const BigInt &rhs);
+BigInt operator%(BigInt lhs, const BigInt &rhs);
+
+// Output-parameter arithmetic 输出参数形式的算术运算
+void add(BigInt &dst, const BigInt &a, const BigInt &b);
+void sub(BigInt &dst, const BigInt &a, const BigInt &b);
+void mul(BigInt &dst, const BigInt &a, const BigInt &b); 
+void addmul(BigInt &dst, const BigInt &a, const BigInt &b);
+void submul(BigInt &dst, const BigInt &a, const BigInt &b);
+
+// Number theory 数论
+BigInt gcd(const BigInt &a, const BigInt &b);
+
+// Hash support for unordered containers 为无序容器提供哈希支持
+namespace std
+{
+    template <>
+    struct hash<BigInt>
+    {
+        size_t operator()(const BigInt &value) const noexcept
+        {
+            return value.hash();
+        }
+    };
+}
+
+// Compile-time BigInt literals 编译时 BigInt 字面量
+namespace bigint_literal
+{
+    // Digits of the literal made of Chars, converted at compile time 由 Chars 组成的字面量的数字，在编译时转换
+    template <char... Chars>
+    struct LiteralDigits
+    {
+        static constexpr char text[sizeof...(Chars)] = {Chars...};
+
+        // Decimal digits with optional ' separators, and no leading zero 十进制数字，可以包含 ' 分隔符，不能有前导零
+        static constexpr bool valid()
+        {
+            for (char c : text)
+            {
+                if (c != '\'' && (c < '0' || c > '9'))
+                {
+                    return false;
+                }
+            }
+            return text[0] != '0' || sizeof...(Chars) == 1;
+        }
+
+        static constexpr size_t countDigits()
+        {
+            size_t count = 0;
+            for (char c : text)
+            {
+                count += (c != '\'');
+            }
+            return count;
+        }
+        static constexpr size_t length = countDigits();
+
+        // Little-endian digits 小端存储的数字
+        struct Digits
+        {
+            uint8_t value[length];
+        };
+        static constexpr Digits convert()
+        {
+            Digits digits{};
+            size_t j = 0;
+            for (size_t i = sizeof...(Chars); i-- > 0;)
+            {
+                if (text[i] != '\'')
+                {
+                    digits.value[j++] = static_cast<uint8_t>(text[i] - '0');
+                }
+            }
+            return digits;
+        }
+        // Lives in read-only storage, no parsing happens at runtime 存放在只读存储中，运行时不做任何解析
+        static constexpr Digits digits = convert();
+    };
+}
+
+// _big literal, e.g. 123456789012345678901234567890_big. Negative values are written as -123_big
+// _big 字面量，例如 123456789012345678901234567890_big。负数写作 -123_big
+template <char... Chars>
+BigInt operator""_big()
+{
+    using Literal = bigint_literal::LiteralDigits<Chars...>;
+    static_assert(Literal::valid(), "_big literals must be decimal integers without leading zeros");
+    return BigInt::fromDigits(Literal::digits.value, Literal::length, true);
+}
+
+// Arithmetic operators with a built-in integer 与内置整数的算术运算符
+template <typename T, typename = enable_if_t<is_integral<T>::value>>
+BigInt operator+(BigInt lhs, T rhs)
+{
+    lhs += rhs;
+    return lhs;
+}
+
+template <typename T, typename = enable_if_t<is_integral<T>::value>>
+BigInt operator-(BigInt lhs, T rhs)
+{
+    lhs -= rhs;
+    return lhs;
+}
+
+template <typename T, typename = enable_if_t<is_integral<T>::value>>
+BigInt operator*(BigInt lhs, T rhs)
+{
+    lhs *= rhs;
+    return lhs;
+}
+
+template <typename T, typename = enable_if_t<is_integral<T>::value>>
+BigInt operator/(BigInt lhs, T rhs)
+{
+    lhs /= rhs;
+    return lhs;
+}
+
+template <typename T, typename = enable_if_t<is_integral<T>::value>>
+BigInt operator%(BigInt lhs, T rhs)
+{
+    lhs %= rhs;
+    return lhs;
+}
+
+// Template members 模板成员
+template <typename T>
+uint64_t BigInt::scalarMagnitude(T value)
+{
+    // Negating in unsigned arithmetic also works for the most negative value
+    // 在无符号运算中取负，对最小负数也成立
+    return scalarSign(value) ? static_cast<uint64_t>(value) : 0 - static_cast<uint64_t>(value);
+}
+
+template <typename T>
+bool BigInt::scalarSign(T value)
+{
+    if constexpr (is_signed<T>::value)
+    {
+        return value >= 0;
+    }
+    else
+    {
+        return true;
+    }
+}
+
+template <typename T, typename>
+BigInt &BigInt::operator+=(T rhs)
+{
+    addScalar(scalarMagnitude(rhs), scalarSign(rhs));
+    return *this;
+}
+
+template <typename T, typename>
+BigInt &BigInt::operator-=(T rhs)
+{
+    addScalar(scalarMagnitude(rhs), !scalarSign(rhs));
+    return *this;
+}
+
+template <typename T, typename>
+BigInt &BigInt::operator*=(T rhs)
+{
+    mulScalar(scalarMagnitude(rhs), scalarSign(rhs));
+    return *this;
+}
+
+template <typename T, typename>
+BigInt &BigInt::operator/=(T rhs)
+{
+    divScalar(scalarMagnitude(rhs), scalarSign(rhs), false);
+    return *this;
+}
+
+template <typename T, typename>
+BigInt &BigInt::operator%=(T rhs)
+{
+    divScalar(scalarMagnitude(rhs), scalarSign(rhs), true);
+    return *this;
+}
+
+template <typename T, typename>
+bool BigInt::operator==(T rhs) const
+{
+    return compareScalar(scalarMagnitude(rhs), scalarSign(rhs)) == 0;
+}
+
+template <typename T, typename>
+bool BigInt::operator!=(T rhs) const
+{
+    return compareScalar(scalarMagnitude(rhs), scalarSign(rhs)) != 0;
+}
+
+template <typename T, typename>
+bool BigInt::operator<(T rhs) const
+{
+    return compareScalar(scalarMagnitude(rhs), scalarSign(rhs)) < 0;
+}
+
+template <typename T, typename>
+bool BigInt::operator>(T rhs) const
+{
+    return compareScalar(scalarMagnitude(rhs), scalarSign(rhs)) > 0;
+}
+
+template <typename T, typename>
+bool BigInt::operator<=(T rhs) const
+{
+    return compareScalar(scalarMagnitude(rhs), scalarSign(rhs)) <= 0;
+}
+
+template <typename T, typename>
+bool BigInt::operator>=(T rhs) const
+{
+    return compareScalar(scalarMagnitude(rhs), scalarSign(rhs)) >= 0;
+}
@@ -0,0 +1,250 @@
+#include "BigIntAccumulator.hpp"
+
+using namespace std;
+
+/**
+ * @brief Number of additions after which the carries are propagated. Each addition changes a column
+ * by at most 9, so the columns stay far away from overflowing int64_t.
+ * 累加多少次后处理一次进位。每次累加对一列的改变最多为 9，因此各列远不会溢出 int64_t。
+ */
+static const uint64_t PROPAGATE_INTERVAL = uint64_t(1) << 58;
+
+/**
+ * @brief Constructor, the initial sum is zero.
+ * 构造函数，初始和为零。
+ */
+BigIntAccumulator::BigIntAccumulator()
+{
+    this->pending = 0;
+}
+
+/**
+ * @brief += operator (BigInt).
+ * += 运算符（BigInt）。
+ *
+ * @param value
+ * @return BigIntAccumulator&
+ */
+BigIntAccumulator &BigIntAccumulator::operator+=(const BigInt &value)
+{
+    addDigits(value.digits, value.sign);
+    return *this;
+}
+
+/**
+ * @brief -= operator (BigInt).
+ * -= 运算符（BigInt）。
+ *
+ * @param value
+ * @return BigIntAccumulator&
+ */
+BigIntAccumulator &BigIntAccumulator::operator-=(const BigInt &value)
+{
+    addDigits(value.digits, !value.sign);
+    return *this;
+}
+
+/**
+ * @brief += operator (int64_t).
+ * += 运算符（int64_t）。
+ *
+ * @param value
+ * @return BigIntAccumulator&
+ */
+BigIntAccumulator &BigIntAccumulator::operator+=(int64_t value)
+{
+    // Negating in unsigned arithmetic also works for INT64_MIN
+    // 在无符号运算中取负，对 INT64_MIN 也成立
+    if (value >= 0)
+    {
+        addMagnitude(static_cast<uint64_t>(value), true);
+    }
+    else
+    {
+        addMagnitude(0 - static_cast<uint64_t>(value), false);
+    }
+    return *this;
+}
+
+/**
+ * @brief -= operator (int64_t).
+ * -= 运算符（int64_t）。
+ *
+ * @param value
+ * @return BigIntAccumulator&
+ */
+BigIntAccumulator &BigIntAccumulator::operator-=(int64_t value)
+{
+    if (value >= 0)
+    {
+        addMagnitude(static_cast<uint64_t>(value), false);
+    }
+    else
+    {
+        addMagnitude(0 - static_cast<uint64_t>(value), true);
+    }
+    return *this;
+}
+
+/**
+ * @brief Resolves the carries and returns the sum. The accumulator itself is not changed.
+ * 处理进位并返回累加和。累加器本身不会改变。
+ *
+ * @return BigInt
+ */
+BigInt BigIntAccumulator::result() const
+{
+    BigInt sum;
+    DigitVector &digits = sum.digits.overwrite();
+    digits.clear();
+    digits.reserve(this->columns.size() + 20);
+
+    // Floor division carries, every digit ends up in [0, 9]
+    // 使用向下取整的除法处理进位，每一位最终都在 [0, 9] 内
+    int64_t carry = 0;
+    for (size_t i = 0; i < this->columns.size(); ++i)
+    {
+        int64_t current = this->columns[i] + carry;
+        int64_t digit = current % 10;
+        carry = current / 10;
+        if (digit < 0)
+        {
+            digit += 10;
+            carry -= 1;
+        }
+        digits.push_back(static_cast<uint8_t>(digit));
+    }
+    // A positive carry converges to 0, a negative one to -1
+    // 正的进位最终收敛为 0，负的进位最终收敛为 -1
+    while (carry != 0 && carry != -1)
+    {
+        int64_t digit = carry % 10;
+        carry = carry / 10;
+        if (digit < 0)
+        {
+            digit += 10;
+            carry -= 1;
+        }
+        digits.push_back(static_cast<uint8_t>(digit));
+    }
+
+    // A final carry of -1 means the sum is D - 10^k, whose absolute value is the ten's complement of D
+    // 最终进位为 -1 表示累加和为 D - 10^k，其绝对值是 D 的十进制补码
+    sum.sign = true;
+    if (carry == -1)
+    {
+        sum.sign = false;
+        bool borrow = false;
+        for (size_t i = 0; i < digits.size(); ++i)
+        {
+            int subtraction = 0 - int(digits[i]) - borrow;
+            borrow = subtraction < 0;
+            if (borrow)
+            {
+                subtraction += 10;
+            }
+            digits[i] = static_cast<uint8_t>(subtraction);
+        }
+    }
+
+    if (digits.empty())
+    {
+        digits.push_back(0);
+    }
+    sum.normalize();
+    return sum;
+}
+
+/**
+ * @brief Resets the sum to zero, keeping the buffer.
+ * 将累加和重置为零，保留缓冲区。
+ */
+void BigIntAccumulator::clear()
+{
+    this->columns.clear();
+    this->pending = 0;
+}
+
+/**
+ * @brief Adds (or subtracts) a little-endian digit sequence column by column, without carrying.
+ * 逐列加上（或减去）小端存储的数字序列，不处理进位。
+ *
+ * @param digits
+ * @param positive true to add, false to subtract. true 为加，false 为减。
+ */
+void BigIntAccumulator::addDigits(const DigitVector &digits, bool positive)
+{
+    if (this->columns.size() < digits.size())
+    {
+        this->columns.resize(digits.size(), 0);
+    }
+    if (positive)
+    {
+        for (size_t i = 0; i < digits.size(); ++i)
+        {
+            this->columns[i] += digits[i];
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < digits.size(); ++i)
+        {
+            this->columns[i] -= digits[i];
+        }
+    }
+    if (++this->pending >= PROPAGATE_INTERVAL)
+    {
+        propagateCarries();
+    }
+}
+
+/**
+ * @brief Adds (or subtracts) the absolute value of a 64-bit integer, split into decimal digits.
+ * 加上（或减去）64 位整数的绝对值，按十进制位拆分。
+ *
+ * @param magnitude Absolute value. 绝对值。
+ * @param positive true to add, false to subtract. true 为加，false 为减。
+ */
+void BigIntAccumulator::addMagnitude(uint64_t magnitude, bool positive)
+{
+    for (size_t i = 0; magnitude != 0; ++i)
+    {
+        if (i == this->columns.size())
+        {
+            this->columns.push_back(0);
+        }
+        int64_t digit = static_cast<int64_t>(magnitude % 10);
+        this->columns[i] += positive ? digit : -digit;
+        magnitude /= 10;
+    }
+    if (++this->pending >= PROPAGATE_INTERVAL)
+    {
+        propagateCarries();
+    }
+}
+
+/**
+ * @brief Propagates the carries in place. The value is unchanged, every column but the last ends up in [0, 9].
+ * 原地处理进位。值保持不变，除最后一列外每一列都在 [0, 9] 内。
+ */
+void BigIntAccumulator::propagateCarries()
+{
+    int64_t carry = 0;
+    for (size_t i = 0; i < this->columns.size(); ++i)
+    {
+        int64_t current = this->columns[i] + carry;
+        int64_t digit = current % 10;
+        carry = current / 10;
+        if (digit < 0)
+        {
+            digit += 10;
+            carry -= 1;
+        }
+        this->columns[i] = digit;
+    }
+    if (carry != 0)
+    {
+        this->columns.push_back(carry);
+    }
+    this->pending = 0;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "BigInt.hpp"
+
+// Accumulates many BigInt and 64-bit values, carries are resolved only when the result is requested
+// 累加大量 BigInt 和 64 位整数，只有在获取结果时才处理进位
+class BigIntAccumulator
+{
+public:
+    // Constructor, the initial sum is zero 构造函数，初始和为零
+    BigIntAccumulator();
+
+    // Accumulation operators 累加运算符
+    BigIntAccumulator &operator+=(const BigInt &value);
+    BigIntAccumulator &operator-=(const BigInt &value);
+    BigIntAccumulator &operator+=(int64_t value);
+    BigIntAccumulator &operator-=(int64_t value);
+
+    // Resolves the carries and returns the sum 处理进位并返回累加和
+    BigInt result() const;
+    // Resets the sum to zero, keeping the buffer 将累加和重置为零，保留缓冲区
+    void clear();
+
+private:
+    // Column i holds an unnormalized multiple of 10^i 第 i 列保存 10^i 的未规范化倍数
+    vector<int64_t> columns;
+    // Number of additions since the carries were last propagated 上次处理进位以来的累加次数
+    uint64_t pending;
+    // Adds (or subtracts) a little-endian digit sequence column by column 逐列加上（或减去）小端存储的数字序列
+    void addDigits(const DigitVector &digits, bool positive);
+    // Adds (or subtracts) the absolute value of a 64-bit integer 加上（或减去）64 位整数的绝对值
+    void addMagnitude(uint64_t magnitude, bool positive);
+    // Propagates the carries in place so that the columns cannot overflow 原地处理进位，避免各列溢出
+    void propagateCarries();
+};
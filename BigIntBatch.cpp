@@ -0,0 +1,477 @@
+#include "BigIntBatch.hpp"
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Smallest number of values given to one thread by the parallel kernels.
+ * 并行内核分配给每个线程的最少值个数。
+ */
+static const size_t MIN_VALUES_PER_THREAD = 4096;
+
+/**
+ * @brief Runs body over [0, count), split into contiguous ranges across threads when parallel is set
+ * and the batch is large enough.
+ * 在 [0, count) 上执行 body，parallel 为 true 且批次足够大时拆分为连续区间分配到多个线程。
+ *
+ * @param count Number of values. 值的个数。
+ * @param parallel Whether to use several threads. 是否使用多个线程。
+ * @param body Called with [begin, end). 以 [begin, end) 调用。
+ */
+static void forEachRange(size_t count, bool parallel, const function<void(size_t, size_t)> &body)
+{
+    size_t threadCount = parallel ? min<size_t>(thread::hardware_concurrency(), count / MIN_VALUES_PER_THREAD) : 1;
+    if (threadCount <= 1)
+    {
+        body(0, count);
+        return;
+    }
+    vector<thread> threads;
+    size_t chunk = (count + threadCount - 1) / threadCount;
+    for (size_t begin = 0; begin < count; begin += chunk)
+    {
+        threads.emplace_back(body, begin, min(count, begin + chunk));
+    }
+    for (thread &worker : threads)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Removes leading zeros from a slot and makes the sign of 0 positive.
+ * 删除槽中的前导零，并把0的符号设为正。
+ *
+ * @param out Digits of the slot. 槽中的数字。
+ * @param length Number of digits used, updated. 使用的位数，会被更新。
+ * @param sign Sign, updated. 符号，会被更新。
+ */
+static void trimSlot(const uint8_t *out, size_t &length, uint8_t &sign)
+{
+    while (length > 1 && out[length - 1] == 0)
+    {
+        --length;
+    }
+    if (length == 1 && out[0] == 0)
+    {
+        sign = 1;
+    }
+}
+
+/**
+ * @brief Compares the absolute values of two digit arrays.
+ * 比较两个数字数组的绝对值。
+ *
+ * @return int -1, 0 or 1.
+ */
+static int compareAbsSlots(const uint8_t *a, size_t aLength, const uint8_t *b, size_t bLength)
+{
+    if (aLength != bLength)
+    {
+        return aLength > bLength ? 1 : -1;
+    }
+    for (size_t i = aLength; i-- > 0;)
+    {
+        if (a[i] != b[i])
+        {
+            return a[i] > b[i] ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Signed addition of one pair of values into a slot of max(aLength, bLength) + 1 digits.
+ * The column sums are computed first in a branch-free loop the compiler can vectorize, then the carries
+ * are propagated in a second pass.
+ * 将一对值的有符号加法结果写入一个 max(aLength, bLength) + 1 位的槽。
+ * 先在编译器可以向量化的无分支循环中计算各列之和，再在第二遍中处理进位。
+ */
+static void addSlot(const uint8_t *a, size_t aLength, uint8_t aSign, const uint8_t *b, size_t bLength, uint8_t bSign,
+                    uint8_t *out, size_t &outLength, uint8_t &outSign)
+{
+    // Make a the operand with the larger absolute value
+    // 让 a 成为绝对值较大的操作数
+    if (compareAbsSlots(a, aLength, b, bLength) < 0)
+    {
+        swap(a, b);
+        swap(aLength, bLength);
+        swap(aSign, bSign);
+    }
+    outSign = aSign;
+    outLength = aLength + 1;
+
+    // Addition with the same sign
+    // 同号相加
+    if (aSign == bSign)
+    {
+        for (size_t i = 0; i < bLength; ++i)
+        {
+            out[i] = static_cast<uint8_t>(a[i] + b[i]);
+        }
+        copy(a + bLength, a + aLength, out + bLength);
+        out[aLength] = 0;
+        uint8_t carry = 0;
+        for (size_t i = 0; i <= aLength; ++i)
+        {
+            uint8_t current = static_cast<uint8_t>(out[i] + carry);
+            carry = current >= 10;
+            out[i] = static_cast<uint8_t>(carry ? current - 10 : current);
+        }
+    }
+    // Addition with different signs, |a| >= |b|
+    // 异号相加，|a| >= |b|
+    else
+    {
+        int8_t *signedOut = reinterpret_cast<int8_t *>(out);
+        for (size_t i = 0; i < bLength; ++i)
+        {
+            signedOut[i] = static_cast<int8_t>(a[i] - b[i]);
+        }
+        copy(a + bLength, a + aLength, out + bLength);
+        out[aLength] = 0;
+        int8_t borrow = 0;
+        for (size_t i = 0; i < aLength; ++i)
+        {
+            int8_t current = static_cast<int8_t>(signedOut[i] - borrow);
+            borrow = current < 0;
+            out[i] = static_cast<uint8_t>(borrow ? current + 10 : current);
+        }
+    }
+    trimSlot(out, outLength, outSign);
+}
+
+/**
+ * @brief Multiplication of one pair of values into a slot of aLength + bLength digits.
+ * The inner loop accumulates whole rows into wide columns without carrying, so it can be vectorized.
+ * 将一对值的乘法结果写入一个 aLength + bLength 位的槽。
+ * 内层循环将整行累加到宽列中而不处理进位，因此可以被向量化。
+ *
+ * @tparam Column Column type, wide enough for min(aLength, bLength) * 81. 列类型，需要能容纳 min(aLength, bLength) * 81。
+ */
+template <typename Column>
+static void mulSlot(const uint8_t *a, size_t aLength, const uint8_t *b, size_t bLength, vector<Column> &columns,
+                    uint8_t *out)
+{
+    columns.assign(aLength + bLength, 0);
+    for (size_t i = 0; i < aLength; ++i)
+    {
+        Column digit = a[i];
+        Column *row = columns.data() + i;
+        for (size_t j = 0; j < bLength; ++j)
+        {
+            row[j] += digit * b[j];
+        }
+    }
+    uint64_t carry = 0;
+    for (size_t i = 0; i < aLength + bLength; ++i)
+    {
+        uint64_t current = columns[i] + carry;
+        out[i] = static_cast<uint8_t>(current % 10);
+        carry = current / 10;
+    }
+}
+
+/**
+ * @brief Lays out the slots from the capacity needed by each value. Only the slot offsets are
+ * computed here, the kernels then fill disjoint slots independently.
+ * 根据每个值需要的容量安排槽。这里只计算槽的偏移量，之后各内核独立填充互不重叠的槽。
+ *
+ * @param count Number of values. 值的个数。
+ * @param capacity Slot size of value i. 第 i 个值的槽大小。
+ */
+void BigIntBatch::layout(size_t count, const function<size_t(size_t)> &capacity)
+{
+    this->offsets.resize(count + 1);
+    this->offsets[0] = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        this->offsets[i + 1] = this->offsets[i] + capacity(i);
+    }
+    this->digits.resize(this->offsets[count]);
+    this->lengths.resize(count);
+    this->signs.resize(count);
+}
+
+/**
+ * @brief Batch the result is built in: dst itself, or a per-thread batch when dst is an operand
+ * (the caller then swaps it with dst, like mul(BigInt &, ...)).
+ * 构建结果的批次：dst 本身；当 dst 是操作数时为线程内的批次（之后由调用者与 dst 交换，与 mul(BigInt &, ...) 相同）。
+ *
+ * @param dst
+ * @param a
+ * @param b
+ * @return BigIntBatch&
+ */
+BigIntBatch &BigIntBatch::target(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b)
+{
+    if (a.count() != b.count())
+    {
+        throw invalid_argument("BigIntBatch operands have different counts");
+    }
+    if (&dst == &a || &dst == &b)
+    {
+        thread_local BigIntBatch buffer;
+        return buffer;
+    }
+    return dst;
+}
+
+/**
+ * @brief Empty batch.
+ * 空批次。
+ */
+BigIntBatch::BigIntBatch()
+{
+    this->offsets.push_back(0);
+}
+
+/**
+ * @brief Copies the values into one contiguous buffer.
+ * 将各个值拷贝到一个连续的缓冲区中。
+ *
+ * @param values
+ */
+BigIntBatch::BigIntBatch(const vector<BigInt> &values)
+{
+    this->offsets.push_back(0);
+    size_t totalDigits = 0;
+    for (const BigInt &value : values)
+    {
+        totalDigits += value.digits.size();
+    }
+    this->digits.reserve(totalDigits);
+    this->offsets.reserve(values.size() + 1);
+    this->lengths.reserve(values.size());
+    this->signs.reserve(values.size());
+    for (const BigInt &value : values)
+    {
+        append(value);
+    }
+}
+
+/**
+ * @brief Appends a value.
+ * 追加一个值。
+ *
+ * @param value
+ */
+void BigIntBatch::append(const BigInt &value)
+{
+    this->digits.insert(this->digits.end(), value.digits.begin(), value.digits.end());
+    this->offsets.push_back(this->digits.size());
+    this->lengths.push_back(value.digits.size());
+    this->signs.push_back(value.sign);
+}
+
+/**
+ * @brief Reserves space for count values of about digitsPerValue digits.
+ * 为 count 个约 digitsPerValue 位的值预留空间。
+ *
+ * @param count
+ * @param digitsPerValue
+ */
+void BigIntBatch::reserve(size_t count, size_t digitsPerValue)
+{
+    this->digits.reserve(count * digitsPerValue);
+    this->offsets.reserve(count + 1);
+    this->lengths.reserve(count);
+    this->signs.reserve(count);
+}
+
+/**
+ * @brief Removes all values, keeping the buffers.
+ * 删除所有值，保留缓冲区。
+ */
+void BigIntBatch::clear()
+{
+    this->digits.clear();
+    this->offsets.assign(1, 0);
+    this->lengths.clear();
+    this->signs.clear();
+}
+
+/**
+ * @brief Number of values.
+ * 值的个数。
+ *
+ * @return size_t
+ */
+size_t BigIntBatch::count() const
+{
+    return this->lengths.size();
+}
+
+/**
+ * @brief Returns the value at index as a separate BigInt.
+ * 以独立的 BigInt 返回 index 处的值。
+ *
+ * @param index
+ * @return BigInt
+ */
+BigInt BigIntBatch::get(size_t index) const
+{
+    if (index >= count())
+    {
+        throw out_of_range("BigIntBatch index out of range");
+    }
+    BigInt value;
+    const uint8_t *slot = this->digits.data() + this->offsets[index];
+    value.digits.assign(slot, slot + this->lengths[index]);
+    value.sign = this->signs[index];
+    return value;
+}
+
+/**
+ * @brief Converts back to separate BigInts.
+ * 转换回独立的 BigInt。
+ *
+ * @return vector<BigInt>
+ */
+vector<BigInt> BigIntBatch::toVector() const
+{
+    vector<BigInt> values;
+    values.reserve(count());
+    for (size_t i = 0; i < count(); ++i)
+    {
+        values.push_back(get(i));
+    }
+    return values;
+}
+
+/**
+ * @brief Shared implementation of add and sub, the sign of b is flipped for sub.
+ * add 和 sub 的公共实现，sub 时翻转 b 的符号。
+ *
+ * @param dst
+ * @param a
+ * @param b
+ * @param parallel
+ * @param negateB Whether to subtract b. 是否减去 b。
+ */
+void BigIntBatch::addOrSub(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel, bool negateB)
+{
+    BigIntBatch &out = target(dst, a, b);
+    out.layout(a.count(), [&](size_t i)
+               { return max(a.lengths[i], b.lengths[i]) + 1; });
+    forEachRange(a.count(), parallel, [&](size_t begin, size_t end)
+                 {
+        for (size_t i = begin; i < end; ++i)
+        {
+            uint8_t bSign = negateB ? !b.signs[i] : b.signs[i];
+            addSlot(a.digits.data() + a.offsets[i], a.lengths[i], a.signs[i],
+                    b.digits.data() + b.offsets[i], b.lengths[i], bSign,
+                    out.digits.data() + out.offsets[i], out.lengths[i], out.signs[i]);
+        } });
+    if (&out != &dst)
+    {
+        swap(dst, out);
+    }
+}
+
+/**
+ * @brief Elementwise addition, dst[i] = a[i] + b[i].
+ * 逐元素加法，dst[i] = a[i] + b[i]。
+ *
+ * @param dst Destination, may be a or b. 目标，可以是 a 或 b。
+ * @param a
+ * @param b
+ * @param parallel Split large batches across threads. 将大批次分配到多个线程。
+ */
+void add(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel)
+{
+    BigIntBatch::addOrSub(dst, a, b, parallel, false);
+}
+
+/**
+ * @brief Elementwise subtraction, dst[i] = a[i] - b[i].
+ * 逐元素减法，dst[i] = a[i] - b[i]。
+ *
+ * @param dst Destination, may be a or b. 目标，可以是 a 或 b。
+ * @param a
+ * @param b
+ * @param parallel Split large batches across threads. 将大批次分配到多个线程。
+ */
+void sub(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel)
+{
+    BigIntBatch::addOrSub(dst, a, b, parallel, true);
+}
+
+/**
+ * @brief Elementwise multiplication, dst[i] = a[i] * b[i].
+ * 逐元素乘法，dst[i] = a[i] * b[i]。
+ *
+ * @param dst Destination, may be a or b. 目标，可以是 a 或 b。
+ * @param a
+ * @param b
+ * @param parallel Split large batches across threads. 将大批次分配到多个线程。
+ */
+void mul(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel)
+{
+    BigIntBatch &out = BigIntBatch::target(dst, a, b);
+    out.layout(a.count(), [&](size_t i)
+               { return a.lengths[i] + b.lengths[i]; });
+    forEachRange(a.count(), parallel, [&](size_t begin, size_t end)
+                 {
+        // 32-bit columns hold up to 2^32 / 81 products, which covers all practical operand lengths
+        // 32 位的列最多容纳 2^32 / 81 个乘积，足以覆盖所有实际的操作数长度
+        const size_t narrowLimit = UINT32_MAX / 81;
+        vector<uint32_t> narrowColumns;
+        vector<uint64_t> wideColumns;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const uint8_t *x = a.digits.data() + a.offsets[i];
+            const uint8_t *y = b.digits.data() + b.offsets[i];
+            uint8_t *slot = out.digits.data() + out.offsets[i];
+            if (min(a.lengths[i], b.lengths[i]) < narrowLimit)
+            {
+                mulSlot(x, a.lengths[i], y, b.lengths[i], narrowColumns, slot);
+            }
+            else
+            {
+                mulSlot(x, a.lengths[i], y, b.lengths[i], wideColumns, slot);
+            }
+            out.lengths[i] = a.lengths[i] + b.lengths[i];
+            out.signs[i] = a.signs[i] == b.signs[i];
+            trimSlot(slot, out.lengths[i], out.signs[i]);
+        } });
+    if (&out != &dst)
+    {
+        swap(dst, out);
+    }
+}
+
+/**
+ * @brief Elementwise comparison.
+ * 逐元素比较。
+ *
+ * @param a
+ * @param b
+ * @param parallel Split large batches across threads. 将大批次分配到多个线程。
+ * @return vector<int> result[i] is -1, 0 or 1 as a[i] is less than, equal to or greater than b[i].
+ * result[i] 为 -1、0 或 1，分别表示 a[i] 小于、等于或大于 b[i]。
+ */
+vector<int> compare(const BigIntBatch &a, const BigIntBatch &b, bool parallel)
+{
+    if (a.count() != b.count())
+    {
+        throw invalid_argument("BigIntBatch operands have different counts");
+    }
+    vector<int> result(a.count());
+    forEachRange(a.count(), parallel, [&](size_t begin, size_t end)
+                 {
+        for (size_t i = begin; i < end; ++i)
+        {
+            if (a.signs[i] != b.signs[i])
+            {
+                result[i] = a.signs[i] ? 1 : -1;
+                continue;
+            }
+            int comparison = compareAbsSlots(a.digits.data() + a.offsets[i], a.lengths[i],
+                                             b.digits.data() + b.offsets[i], b.lengths[i]);
+            result[i] = a.signs[i] ? comparison : -comparison;
+        } });
+    return result;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "BigInt.hpp"
+#include <functional>
+
+// Structure-of-arrays container for many BigInts, the digits of all values are stored contiguously
+// 存放大量 BigInt 的结构数组容器，所有值的数字连续存储
+class BigIntBatch
+{
+public:
+    // Constructors 构造函数
+    // Empty batch 空批次
+    BigIntBatch();
+    // Copies the values into one contiguous buffer 将各个值拷贝到一个连续的缓冲区中
+    explicit BigIntBatch(const vector<BigInt> &values);
+
+    // Appends a value 追加一个值
+    void append(const BigInt &value);
+    // Reserves space for count values of about digitsPerValue digits 为 count 个约 digitsPerValue 位的值预留空间
+    void reserve(size_t count, size_t digitsPerValue);
+    // Removes all values, keeping the buffers 删除所有值，保留缓冲区
+    void clear();
+
+    // Number of values 值的个数
+    size_t count() const;
+    // Returns the value at index as a separate BigInt 以独立的 BigInt 返回 index 处的值
+    BigInt get(size_t index) const;
+    // Converts back to separate BigInts 转换回独立的 BigInt
+    vector<BigInt> toVector() const;
+
+    // Elementwise kernels, dst may be a or b 逐元素内核，dst 可以是 a 或 b
+    friend void add(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel);
+    friend void sub(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel);
+    friend void mul(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel);
+    friend vector<int> compare(const BigIntBatch &a, const BigIntBatch &b, bool parallel);
+
+private:
+    // Lays out the slots from the capacity needed by each value 根据每个值需要的容量安排槽
+    void layout(size_t count, const function<size_t(size_t)> &capacity);
+    // Batch the result is built in, a per-thread batch when dst is an operand 构建结果的批次，dst 是操作数时为线程内的批次
+    static BigIntBatch &target(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b);
+    // Shared implementation of add and sub add 和 sub 的公共实现
+    static void addOrSub(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel, bool negateB);
+
+    // Digits of all values, value i occupies the slot [offsets[i], offsets[i + 1]) 所有值的数字，第 i 个值占据 [offsets[i], offsets[i + 1])
+    vector<uint8_t> digits;
+    // Start of each slot, count + 1 entries 每个槽的起始位置，共 count + 1 项
+    vector<size_t> offsets;
+    // Number of digits used in each slot 每个槽中实际使用的位数
+    vector<size_t> lengths;
+    // Sign of each value (1 for positive) 每个值的符号（正数为 1）
+    vector<uint8_t> signs;
+};
+
+// Elementwise arithmetic, dst[i] = a[i] op b[i]. a and b must have the same count. With parallel set,
+// large batches are split across threads 逐元素算术运算，dst[i] = a[i] op b[i]。a 和 b 的个数必须相同。parallel 为 true 时大批次会分配到多个线程
+void add(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel = false);
+void sub(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel = false);
+void mul(BigIntBatch &dst, const BigIntBatch &a, const BigIntBatch &b, bool parallel = false);
+// Elementwise comparison, result[i] is -1, 0 or 1 逐元素比较，result[i] 为 -1、0 或 1
+vector<int> compare(const BigIntBatch &a, const BigIntBatch &b, bool parallel = false);
@@ -0,0 +1,550 @@
+#include "BigInt.hpp"
+#include <algorithm>
+#include <random>
+
+using namespace std;
+
+/**
+ * @brief Base of the limbs used by the modular arithmetic, nine decimal digits per limb.
+ * 模运算使用的limb的基数，每个limb包含九位十进制数字。
+ */
+static const uint64_t LIMB_BASE = 1000000000;
+static const size_t LIMB_DIGITS = 9;
+
+/**
+ * @brief Small primes are below this bound.
+ * 小素数都小于该上界。
+ */
+static const uint32_t SMALL_PRIME_LIMIT = 2048;
+
+/**
+ * @brief Products of consecutive small primes stay below this bound, so one remainder pass
+ * over the limbs fits in 64 bits (remainder * 10^9 + limb < 2^64).
+ * 连续小素数之积保持在该上界以下，使一次遍历limb的求余能放进64位（余数 * 10^9 + limb < 2^64）。
+ */
+static const uint64_t PRIME_GROUP_LIMIT = uint64_t(1) << 34;
+
+/**
+ * @brief Primes below SMALL_PRIME_LIMIT. Those other than 2 and 5 are grouped into products below PRIME_GROUP_LIMIT.
+ * 小于 SMALL_PRIME_LIMIT 的素数。除2和5以外的素数按乘积小于 PRIME_GROUP_LIMIT 分组。
+ */
+struct SmallPrimes
+{
+    // All primes below the limit, including 2 and 5 小于上界的所有素数，包括2和5
+    vector<uint32_t> primes;
+    // The primes used by the remainder pass, all but 2 and 5 求余遍历使用的素数，即除2和5以外的所有素数
+    vector<uint32_t> grouped;
+    // Product of each group 每组的乘积
+    vector<uint64_t> products;
+    // Group i holds grouped[groupStart[i], groupStart[i + 1]) 第 i 组为 grouped[groupStart[i], groupStart[i + 1])
+    vector<size_t> groupStart;
+};
+
+/**
+ * @brief Sieves the small primes once and groups them.
+ * 筛出小素数（只做一次）并分组。
+ *
+ * @return const SmallPrimes&
+ */
+static const SmallPrimes &smallPrimes()
+{
+    static const SmallPrimes table = []()
+    {
+        SmallPrimes result;
+        vector<bool> composite(SMALL_PRIME_LIMIT, false);
+        for (uint32_t i = 2; i < SMALL_PRIME_LIMIT; ++i)
+        {
+            if (composite[i])
+            {
+                continue;
+            }
+            result.primes.push_back(i);
+            for (uint32_t j = i * i; j < SMALL_PRIME_LIMIT; j += i)
+            {
+                composite[j] = true;
+            }
+        }
+        // 2 and 5 are checked from the last decimal digit, the groups start at 3
+        // 2和5通过最低位十进制数字检查，分组从3开始
+        uint64_t product = 1;
+        for (uint32_t prime : result.primes)
+        {
+            if (prime == 2 || prime == 5)
+            {
+                continue;
+            }
+            if (product * prime >= PRIME_GROUP_LIMIT)
+            {
+                result.products.push_back(product);
+                product = 1;
+            }
+            if (product == 1)
+            {
+                result.groupStart.push_back(result.grouped.size());
+            }
+            result.grouped.push_back(prime);
+            product *= prime;
+        }
+        result.products.push_back(product);
+        result.groupStart.push_back(result.grouped.size());
+        return result;
+    }();
+    return table;
+}
+
+/**
+ * @brief Regroups little-endian decimal digits into little-endian limbs of nine digits.
+ * 将小端存储的十进制数字重新组合为小端存储的九位limb。
+ *
+ * @param digits
+ * @return vector<uint32_t>
+ */
+static vector<uint32_t> toLimbs(const DigitVector &digits)
+{
+    vector<uint32_t> limbs((digits.size() + LIMB_DIGITS - 1) / LIMB_DIGITS, 0);
+    for (size_t i = digits.size(); i-- > 0;)
+    {
+        limbs[i / LIMB_DIGITS] = limbs[i / LIMB_DIGITS] * 10 + digits[i];
+    }
+    return limbs;
+}
+
+/**
+ * @brief Remainder of the limbs modulo a divisor below PRIME_GROUP_LIMIT.
+ * limb 对小于 PRIME_GROUP_LIMIT 的除数的余数。
+ *
+ * @param limbs
+ * @param divisor
+ * @return uint64_t
+ */
+static uint64_t remainderOf(const vector<uint32_t> &limbs, uint64_t divisor)
+{
+    uint64_t remainder = 0;
+    for (size_t i = limbs.size(); i-- > 0;)
+    {
+        remainder = (remainder * LIMB_BASE + limbs[i]) % divisor;
+    }
+    return remainder;
+}
+
+/**
+ * @brief Compares two limb sequences of the same length.
+ * 比较两个等长的limb序列。
+ *
+ * @return int -1, 0 or 1.
+ */
+static int compareLimbs(const uint32_t *a, const uint32_t *b, size_t length)
+{
+    for (size_t i = length; i-- > 0;)
+    {
+        if (a[i] != b[i])
+        {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Montgomery arithmetic modulo an odd n not divisible by 5, with R = (10^9)^k.
+ * Numbers are k limbs in [0, n), and multiplication reduces with CIOS (interleaved multiply
+ * and REDC), so no division by n is ever needed.
+ * 模 n（奇数且不被5整除）的 Montgomery 运算，R = (10^9)^k。
+ * 数为 [0, n) 内的 k 个limb，乘法使用 CIOS（乘法与 REDC 交替进行）约简，因此从不需要除以 n。
+ */
+class Montgomery
+{
+public:
+    explicit Montgomery(const vector<uint32_t> &modulus) : n(modulus), k(modulus.size()), t(modulus.size() + 2)
+    {
+        // -n^-1 mod 10^9 by Hensel lifting, each step doubles the number of correct digits
+        // 通过 Hensel 提升计算 -n^-1 mod 10^9，每一步使正确的位数加倍
+        uint64_t n0 = this->n[0];
+        uint64_t inverse = 1;
+        while ((n0 * inverse) % 10 != 1)
+        {
+            inverse += 2;
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            uint64_t product = (n0 * inverse) % LIMB_BASE;
+            inverse = inverse * ((2 + LIMB_BASE - product) % LIMB_BASE) % LIMB_BASE;
+        }
+        this->nInverse = (LIMB_BASE - inverse) % LIMB_BASE;
+
+        // R mod n and R^2 mod n, by multiplying 1 by 10 modulo n, 9k and 18k times
+        // 通过在模 n 下将1乘以10，分别乘 9k 次和 18k 次，得到 R mod n 和 R^2 mod n
+        vector<uint32_t> value(this->k, 0);
+        value[0] = 1;
+        for (size_t i = 0; i < LIMB_DIGITS * this->k; ++i)
+        {
+            this->timesTen(value);
+        }
+        this->one = value;
+        for (size_t i = 0; i < LIMB_DIGITS * this->k; ++i)
+        {
+            this->timesTen(value);
+        }
+        this->rSquared = value;
+    }
+
+    // Montgomery form of 1 1 的 Montgomery 形式
+    const vector<uint32_t> &unit() const
+    {
+        return this->one;
+    }
+
+    // Converts a value below n into Montgomery form 将小于 n 的值转换为 Montgomery 形式
+    vector<uint32_t> toMontgomery(const vector<uint32_t> &value)
+    {
+        vector<uint32_t> result(this->k);
+        this->multiply(value.data(), this->rSquared.data(), result.data());
+        return result;
+    }
+
+    // out = a * b / R mod n, out may be a or b out = a * b / R mod n，out 可以是 a 或 b
+    void multiply(const uint32_t *a, const uint32_t *b, uint32_t *out)
+    {
+        fill(this->t.begin(), this->t.end(), 0);
+        uint64_t *t = this->t.data();
+        const uint32_t *n = this->n.data();
+        size_t k = this->k;
+        for (size_t i = 0; i < k; ++i)
+        {
+            // t += a[i] * b
+            // t += a[i] * b
+            uint64_t carry = 0;
+            uint64_t ai = a[i];
+            for (size_t j = 0; j < k; ++j)
+            {
+                uint64_t current = t[j] + ai * b[j] + carry;
+                t[j] = current % LIMB_BASE;
+                carry = current / LIMB_BASE;
+            }
+            uint64_t current = t[k] + carry;
+            t[k] = current % LIMB_BASE;
+            t[k + 1] = current / LIMB_BASE;
+
+            // t = (t + m * n) / 10^9, m makes the lowest limb zero
+            // t = (t + m * n) / 10^9，m 使最低的limb为零
+            uint64_t m = t[0] * this->nInverse % LIMB_BASE;
+            carry = (t[0] + m * n[0]) / LIMB_BASE;
+            for (size_t j = 1; j < k; ++j)
+            {
+                current = t[j] + m * n[j] + carry;
+                t[j - 1] = current % LIMB_BASE;
+                carry = current / LIMB_BASE;
+            }
+            current = t[k] + carry;
+            t[k - 1] = current % LIMB_BASE;
+            t[k] = t[k + 1] + current / LIMB_BASE;
+        }
+        for (size_t j = 0; j < k; ++j)
+        {
+            out[j] = static_cast<uint32_t>(t[j]);
+        }
+        // The result is below 2n, one subtraction brings it into [0, n)
+        // 结果小于 2n，一次减法即可使其落入 [0, n)
+        if (t[k] != 0 || compareLimbs(out, n, k) >= 0)
+        {
+            this->subtractModulus(out);
+        }
+    }
+
+private:
+    // value = value * 10 mod n for value < n value < n 时计算 value = value * 10 mod n
+    void timesTen(vector<uint32_t> &value)
+    {
+        uint64_t carry = 0;
+        for (size_t i = 0; i < this->k; ++i)
+        {
+            uint64_t current = static_cast<uint64_t>(value[i]) * 10 + carry;
+            value[i] = static_cast<uint32_t>(current % LIMB_BASE);
+            carry = current / LIMB_BASE;
+        }
+        // value * 10 < 10n, so at most 9 subtractions
+        // value * 10 < 10n，因此最多减9次
+        while (carry != 0 || compareLimbs(value.data(), this->n.data(), this->k) >= 0)
+        {
+            carry -= this->subtractModulus(value.data());
+        }
+    }
+
+    // Subtracts n from the k low limbs of value, returns the borrow out of them 从 value 的低 k 个limb中减去 n，返回借位
+    uint64_t subtractModulus(uint32_t *value)
+    {
+        int64_t borrow = 0;
+        for (size_t i = 0; i < this->k; ++i)
+        {
+            int64_t current = static_cast<int64_t>(value[i]) - this->n[i] - borrow;
+            borrow = current < 0 ? 1 : 0;
+            value[i] = static_cast<uint32_t>(current + borrow * static_cast<int64_t>(LIMB_BASE));
+        }
+        return static_cast<uint64_t>(borrow);
+    }
+
+    vector<uint32_t> n;
+    size_t k;
+    uint64_t nInverse;
+    vector<uint32_t> one;
+    vector<uint32_t> rSquared;
+    // Accumulator of multiply, k + 2 limbs multiply 的累加器，k + 2 个limb
+    vector<uint64_t> t;
+};
+
+/**
+ * @brief Splits limbs into 32-bit binary words, least significant first, by repeated division by 2^32.
+ * 通过反复除以 2^32，将limb拆分为32位二进制字，从最低位开始。
+ *
+ * @param limbs
+ * @return vector<uint32_t>
+ */
+static vector<uint32_t> toBinaryWords(vector<uint32_t> limbs)
+{
+    vector<uint32_t> words;
+    while (!limbs.empty())
+    {
+        uint64_t remainder = 0;
+        for (size_t i = limbs.size(); i-- > 0;)
+        {
+            uint64_t current = remainder * LIMB_BASE + limbs[i];
+            limbs[i] = static_cast<uint32_t>(current >> 32);
+            remainder = current & 0xFFFFFFFFu;
+        }
+        words.push_back(static_cast<uint32_t>(remainder));
+        while (!limbs.empty() && limbs.back() == 0)
+        {
+            limbs.pop_back();
+        }
+    }
+    return words;
+}
+
+/**
+ * @brief Montgomery-form power base^exponent with a fixed 4-bit window.
+ * 使用固定4位窗口计算 Montgomery 形式的幂 base^exponent。
+ *
+ * @param context Montgomery context of the modulus. 模数的 Montgomery 上下文。
+ * @param base Base in Montgomery form. Montgomery 形式的底数。
+ * @param exponent Binary words of the exponent, least significant first. 指数的二进制字，从最低位开始。
+ * @return vector<uint32_t> Result in Montgomery form. Montgomery 形式的结果。
+ */
+static vector<uint32_t> powerMod(Montgomery &context, const vector<uint32_t> &base, const vector<uint32_t> &exponent)
+{
+    // table[i] = base^i
+    // table[i] = base^i
+    vector<vector<uint32_t>> table(16, context.unit());
+    for (size_t i = 1; i < 16; ++i)
+    {
+        context.multiply(table[i - 1].data(), base.data(), table[i].data());
+    }
+    vector<uint32_t> result = context.unit();
+    for (size_t word = exponent.size(); word-- > 0;)
+    {
+        BigIntCancelScope::checkpoint();
+        for (int shift = 28; shift >= 0; shift -= 4)
+        {
+            for (int i = 0; i < 4; ++i)
+            {
+                context.multiply(result.data(), result.data(), result.data());
+            }
+            uint32_t window = (exponent[word] >> shift) & 15;
+            if (window != 0)
+            {
+                context.multiply(result.data(), table[window].data(), result.data());
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Draws a Miller-Rabin base uniformly from [2, upper] by rejection: the top limb is drawn
+ * up to the top limb of upper and the others freely, so at least half of the draws are kept.
+ * 通过拒绝采样从 [2, upper] 中均匀抽取 Miller-Rabin 底数：最高limb不超过 upper 的最高limb，
+ * 其余limb任意抽取，因此至少一半的抽样会被保留。
+ *
+ * @param upper Inclusive upper bound, at least 2, without leading zero limbs. 包含在内的上界，至少为2，没有前导零limb。
+ * @param rng Random number generator. 随机数生成器。
+ * @return vector<uint32_t> Base with as many limbs as upper. 与 upper 的limb数相同的底数。
+ */
+static vector<uint32_t> randomBase(const vector<uint32_t> &upper, mt19937_64 &rng)
+{
+    uniform_int_distribution<uint32_t> limb(0, static_cast<uint32_t>(LIMB_BASE - 1));
+    uniform_int_distribution<uint32_t> top(0, upper.back());
+    vector<uint32_t> base(upper.size(), 0);
+    while (true)
+    {
+        for (size_t i = 0; i + 1 < base.size(); ++i)
+        {
+            base[i] = limb(rng);
+        }
+        base.back() = top(rng);
+        bool small = base[0] < 2 && all_of(base.begin() + 1, base.end(), [](uint32_t value) { return value == 0; });
+        if (!small && compareLimbs(base.data(), upper.data(), upper.size()) <= 0)
+        {
+            return base;
+        }
+    }
+}
+
+/**
+ * @brief Probabilistic primality test. The value is first trial-divided by the primes below 2048:
+ * 2 and 5 from the last digit, the others by one remainder pass per group of primes whose product
+ * fits in 34 bits. Survivors get rounds of Miller-Rabin with bases drawn at random from [2, n - 2],
+ * on a Montgomery powmod in base 10^9. At most a quarter of those bases are liars for a composite n,
+ * so a composite passes all rounds with probability at most 4^-rounds, whatever its form.
+ * Under a BigIntCancelScope, every exponent word and every squaring of a round is a safe point.
+ * 概率素性测试。先用小于2048的素数试除：2和5通过最低位判断，其余素数按乘积不超过34位分组，
+ * 每组只需一次求余遍历。通过试除的值再以从 [2, n - 2] 中随机抽取的底数进行 rounds 轮 Miller-Rabin 测试，
+ * 使用以 10^9 为基数的 Montgomery 模幂。对合数 n，这些底数中至多四分之一会误判，
+ * 因此无论合数的形式如何，它通过全部测试的概率至多为 4^-rounds。
+ * 在 BigIntCancelScope 中，每个指数字和每轮中的每次平方都是安全点。
+ *
+ * @param rounds Number of Miller-Rabin rounds, at least 1. Miller-Rabin 的轮数，至少为1。
+ * @return true The value is prime with high probability. 该值很可能是素数。
+ * @return false The value is certainly not prime. 该值一定不是素数。
+ */
+bool BigInt::isProbablePrime(int rounds) const
+{
+    if (!this->sign)
+    {
+        return false;
+    }
+    const SmallPrimes &table = smallPrimes();
+    const DigitVector &digits = this->digits;
+    vector<uint32_t> limbs = toLimbs(digits);
+
+    // Values below the limit are looked up among the small primes
+    // 小于上界的值直接在小素数中查找
+    if (limbs.size() == 1 && limbs[0] < SMALL_PRIME_LIMIT)
+    {
+        return binary_search(table.primes.begin(), table.primes.end(), limbs[0]);
+    }
+
+    // Trial division
+    // 试除
+    if (digits[0] % 2 == 0 || digits[0] == 5)
+    {
+        return false;
+    }
+    for (size_t group = 0; group < table.products.size(); ++group)
+    {
+        uint64_t remainder = remainderOf(limbs, table.products[group]);
+        for (size_t i = table.groupStart[group]; i < table.groupStart[group + 1]; ++i)
+        {
+            if (remainder % table.grouped[i] == 0)
+            {
+                return false;
+            }
+        }
+    }
+    // No factor below the limit, so values below its square are prime
+    // 没有小于上界的因子，因此小于上界平方的值是素数
+    if (limbs.size() == 1 && limbs[0] < SMALL_PRIME_LIMIT * SMALL_PRIME_LIMIT)
+    {
+        return true;
+    }
+
+    // Miller-Rabin: n - 1 = d * 2^s with d odd
+    // Miller-Rabin：n - 1 = d * 2^s，d 为奇数
+    vector<uint32_t> d = limbs;
+    d[0] -= 1;
+    size_t s = 0;
+    while (d[0] % 2 == 0)
+    {
+        uint64_t remainder = 0;
+        for (size_t i = d.size(); i-- > 0;)
+        {
+            uint64_t current = remainder * LIMB_BASE + d[i];
+            d[i] = static_cast<uint32_t>(current / 2);
+            remainder = current % 2;
+        }
+        ++s;
+    }
+    vector<uint32_t> exponent = toBinaryWords(d);
+
+    Montgomery context(limbs);
+    const vector<uint32_t> &one = context.unit();
+    // n - 1 in Montgomery form is n - R mod n
+    // n - 1 的 Montgomery 形式为 n - R mod n
+    vector<uint32_t> minusOne = limbs;
+    for (size_t i = 0, borrow = 0; i < limbs.size(); ++i)
+    {
+        int64_t current = static_cast<int64_t>(limbs[i]) - one[i] - static_cast<int64_t>(borrow);
+        borrow = current < 0 ? 1 : 0;
+        minusOne[i] = static_cast<uint32_t>(current + static_cast<int64_t>(borrow * LIMB_BASE));
+    }
+
+    // Fixed bases would let composites built to fool them (strong pseudoprimes to every small
+    // prime base) pass, so each round draws its base from [2, n - 2]
+    // 固定底数会让专门构造的合数（对所有小素数底数的强伪素数）通过，因此每轮从 [2, n - 2] 中抽取底数
+    thread_local mt19937_64 rng(random_device{}());
+    vector<uint32_t> minusTwo = limbs;
+    for (size_t i = 0, subtract = 2; subtract != 0; ++i)
+    {
+        uint64_t current = minusTwo[i] + LIMB_BASE - subtract;
+        minusTwo[i] = static_cast<uint32_t>(current % LIMB_BASE);
+        subtract = current < LIMB_BASE ? 1 : 0;
+    }
+    while (minusTwo.back() == 0)
+    {
+        minusTwo.pop_back();
+    }
+    rounds = max(1, rounds);
+    for (int round = 0; round < rounds; ++round)
+    {
+        vector<uint32_t> base = randomBase(minusTwo, rng);
+        base.resize(limbs.size(), 0);
+        vector<uint32_t> x = powerMod(context, context.toMontgomery(base), exponent);
+        if (x == one || x == minusOne)
+        {
+            continue;
+        }
+        bool witness = true;
+        for (size_t i = 1; i < s && witness; ++i)
+        {
+            BigIntCancelScope::checkpoint();
+            context.multiply(x.data(), x.data(), x.data());
+            if (x == minusOne)
+            {
+                witness = false;
+            }
+        }
+        if (witness)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Smallest probable prime greater than this value, stepping over odd candidates.
+ * 大于该值的最小可能素数，逐个检查奇数候选。
+ *
+ * @param rounds Number of Miller-Rabin rounds per candidate. 每个候选的 Miller-Rabin 轮数。
+ * @return BigInt
+ */
+BigInt BigInt::nextPrime(int rounds) const
+{
+    if (*this < 2)
+    {
+        return BigInt(2);
+    }
+    BigInt candidate = *this + 1;
+    if (candidate % 2 == 0)
+    {
+        if (candidate == 2)
+        {
+            return candidate;
+        }
+        candidate += 1;
+    }
+    while (!candidate.isProbablePrime(rounds))
+    {
+        BigIntCancelScope::checkpoint();
+        candidate += 2;
+    }
+    return candidate;
+}
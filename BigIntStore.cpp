@@ -0,0 +1,465 @@
+#include "BigIntStore.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BIGINT_HAVE_MMAP 1
+#endif
+
+using namespace std;
+
+/**
+ * @brief Writes a 64-bit integer in little-endian byte order.
+ * 以小端字节序写入64位整数。
+ *
+ * @param out Destination, 8 bytes. 目标位置，8字节。
+ * @param value
+ */
+static void storeLittleEndian(uint8_t *out, uint64_t value)
+{
+    for (int i = 0; i < 8; ++i)
+    {
+        out[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+/**
+ * @brief Reads a 64-bit integer in little-endian byte order.
+ * 以小端字节序读取64位整数。
+ *
+ * @param in Source, 8 bytes. 来源，8字节。
+ * @return uint64_t
+ */
+static uint64_t loadLittleEndian(const uint8_t *in)
+{
+    uint64_t value = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief Number of limbs in the canonical record of some digits: without leading zeros, and at least one.
+ * Digits from an unnormalized string such as "007" or "" would otherwise make a record that parse rejects.
+ * 这些数字的规范记录中的limb数：没有前导零，且至少为一个。
+ * 否则来自 "007" 或 "" 等未规范化字符串的数字会生成 parse 拒绝的记录。
+ *
+ * @param digits
+ * @return size_t
+ */
+static size_t canonicalLength(const DigitVector &digits)
+{
+    size_t length = digits.size();
+    while (length > 1 && digits[length - 1] == 0)
+    {
+        --length;
+    }
+    return max<size_t>(length, 1);
+}
+
+/**
+ * @brief Size of the record of a value: the header followed by one byte per limb.
+ * 值的记录大小：记录头加上每个limb一个字节。
+ *
+ * @param value
+ * @return size_t
+ */
+size_t serializedSize(const BigInt &value)
+{
+    return BIGINT_RECORD_HEADER_SIZE + canonicalLength(value.digits);
+}
+
+/**
+ * @brief Appends the canonical record of a value: leading zeros are dropped and 0 is written as
+ * non-negative with one limb. The limbs are the digits as stored, so this is one copy.
+ * 追加值的规范记录：去掉前导零，0 写为一个limb的非负数。limb 就是存储的数字，因此只需一次拷贝。
+ *
+ * @param value
+ * @param out Buffer the record is appended to. 追加记录的缓冲区。
+ */
+void serialize(const BigInt &value, vector<uint8_t> &out)
+{
+    const DigitVector &digits = value.digits;
+    size_t length = canonicalLength(digits);
+    bool zero = length == 1 && (digits.empty() || digits[0] == 0);
+    size_t start = out.size();
+    out.resize(start + BIGINT_RECORD_HEADER_SIZE + length, 0);
+    out[start] = value.sign || zero ? 0 : 1;
+    storeLittleEndian(&out[start + 8], length);
+    copy(digits.begin(), digits.begin() + min(length, digits.size()), out.begin() + start + BIGINT_RECORD_HEADER_SIZE);
+}
+
+/**
+ * @brief Reads one record into a new BigInt.
+ * 将一条记录读入新的 BigInt。
+ *
+ * @param data Start of the record. 记录的起始位置。
+ * @param size Bytes available from data. data 之后可用的字节数。
+ * @param consumed Receives the size of the record when not null. 不为空时接收记录的大小。
+ * @return BigInt
+ */
+BigInt deserialize(const uint8_t *data, size_t size, size_t *consumed)
+{
+    BigIntView view;
+    size_t recordSize = 0;
+    if (!BigIntView::parse(data, size, view, recordSize))
+    {
+        throw runtime_error("Malformed BigInt record");
+    }
+    if (consumed != nullptr)
+    {
+        *consumed = recordSize;
+    }
+    return view.toBigInt();
+}
+
+/**
+ * @brief Constructs an empty view, which reads as 0.
+ * 构造空视图，其值为0。
+ */
+BigIntView::BigIntView() : sign(true), limbs(nullptr), length(0)
+{
+}
+
+/**
+ * @brief Checks one record and points a view at its limbs without copying them.
+ * The reserved header bytes must be 0, the record must have at least one limb, every limb must be
+ * a decimal digit and the most significant limb may only be 0 for the value 0.
+ * 检查一条记录并将视图指向其 limb，不进行拷贝。
+ * 保留的头部字节必须为0，记录至少要有一个limb，每个limb必须是十进制数字，且只有值为0时最高位才能为0。
+ *
+ * @param data Start of the record. 记录的起始位置。
+ * @param size Bytes available from data. data 之后可用的字节数。
+ * @param view Receives the view. 接收视图。
+ * @param consumed Receives the size of the record. 接收记录的大小。
+ * @return true The record is well formed. 记录格式正确。
+ * @return false
+ */
+bool BigIntView::parse(const uint8_t *data, size_t size, BigIntView &view, size_t &consumed)
+{
+    if (size < BIGINT_RECORD_HEADER_SIZE || data[0] > 1)
+    {
+        return false;
+    }
+    // Non-zero reserved bytes come from a later version of the format
+    // 保留字节非零说明来自更新版本的格式
+    for (size_t i = 1; i < 8; ++i)
+    {
+        if (data[i] != 0)
+        {
+            return false;
+        }
+    }
+    uint64_t length = loadLittleEndian(data + 8);
+    if (length == 0 || length > size - BIGINT_RECORD_HEADER_SIZE)
+    {
+        return false;
+    }
+    const uint8_t *limbs = data + BIGINT_RECORD_HEADER_SIZE;
+    for (uint64_t i = 0; i < length; ++i)
+    {
+        if (limbs[i] > 9)
+        {
+            return false;
+        }
+    }
+    bool zero = length == 1 && limbs[0] == 0;
+    if (limbs[length - 1] == 0 && !zero)
+    {
+        return false;
+    }
+    // Zero is always stored as non-negative
+    // 0 总是按非负数存储
+    view.sign = data[0] == 0 || zero;
+    view.limbs = limbs;
+    view.length = static_cast<size_t>(length);
+    consumed = BIGINT_RECORD_HEADER_SIZE + view.length;
+    return true;
+}
+
+/**
+ * @brief Sign getter
+ * 符号的获取
+ *
+ * @return true Non-negative. 非负。
+ * @return false Negative. 负数。
+ */
+bool BigIntView::getSign() const
+{
+    return this->sign;
+}
+
+/**
+ * @brief Number of limbs.
+ * 位数。
+ *
+ * @return size_t
+ */
+size_t BigIntView::size() const
+{
+    return this->length == 0 ? 1 : this->length;
+}
+
+/**
+ * @brief Limb at index, least significant first.
+ * index 处的limb，从最低位开始。
+ *
+ * @param index
+ * @return uint8_t
+ */
+uint8_t BigIntView::operator[](size_t index) const
+{
+    return index < this->length ? this->limbs[index] : 0;
+}
+
+/**
+ * @brief Copies the viewed value into a BigInt.
+ * 将视图的值拷贝为 BigInt。
+ *
+ * @return BigInt
+ */
+BigInt BigIntView::toBigInt() const
+{
+    if (this->length == 0)
+    {
+        return BigInt();
+    }
+    return BigInt::fromDigits(this->limbs, this->length, this->sign);
+}
+
+/**
+ * @brief Converts to a decimal string straight from the limbs.
+ * 直接由limb转换为十进制字符串。
+ *
+ * @return string
+ */
+string BigIntView::toString() const
+{
+    if (this->length == 0)
+    {
+        return "0";
+    }
+    string result;
+    result.reserve(this->length + 1);
+    if (!this->sign)
+    {
+        result.push_back('-');
+    }
+    for (size_t i = this->length; i-- > 0;)
+    {
+        result.push_back(static_cast<char>('0' + this->limbs[i]));
+    }
+    return result;
+}
+
+/**
+ * @brief Constructs an unmapped file.
+ * 构造未映射的文件。
+ */
+MappedFile::MappedFile() : mapped(nullptr), length(0)
+{
+}
+
+/**
+ * @brief Unmaps the file.
+ * 取消文件映射。
+ */
+MappedFile::~MappedFile()
+{
+    this->close();
+}
+
+/**
+ * @brief Maps a whole file read-only. Where mmap is not available the file is read into memory.
+ * 以只读方式映射整个文件。没有 mmap 的平台上将文件读入内存。
+ *
+ * @param path
+ * @return true The file was mapped. 文件已映射。
+ * @return false The file cannot be opened. 无法打开文件。
+ */
+bool MappedFile::open(const string &path)
+{
+    this->close();
+#ifdef BIGINT_HAVE_MMAP
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    this->length = static_cast<size_t>(status.st_size);
+    if (this->length > 0)
+    {
+        void *address = mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED)
+        {
+            ::close(fd);
+            this->length = 0;
+            return false;
+        }
+        this->mapped = static_cast<const uint8_t *>(address);
+    }
+    // The mapping stays valid after the descriptor is closed
+    // 关闭文件描述符后映射仍然有效
+    ::close(fd);
+    return true;
+#else
+    ifstream file(path, ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    this->fallback.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    this->mapped = this->fallback.data();
+    this->length = this->fallback.size();
+    return true;
+#endif
+}
+
+/**
+ * @brief Unmaps the file, views into it become invalid.
+ * 取消文件映射，指向它的视图随之失效。
+ */
+void MappedFile::close()
+{
+#ifdef BIGINT_HAVE_MMAP
+    if (this->mapped != nullptr)
+    {
+        munmap(const_cast<uint8_t *>(this->mapped), this->length);
+    }
+#endif
+    this->fallback.clear();
+    this->mapped = nullptr;
+    this->length = 0;
+}
+
+/**
+ * @brief Start of the mapped bytes.
+ * 映射字节的起始位置。
+ *
+ * @return const uint8_t*
+ */
+const uint8_t *MappedFile::data() const
+{
+    return this->mapped;
+}
+
+/**
+ * @brief Number of mapped bytes.
+ * 映射的字节数。
+ *
+ * @return size_t
+ */
+size_t MappedFile::size() const
+{
+    return this->length;
+}
+
+/**
+ * @brief Maps a store file and indexes its records. Only the headers and limbs are checked,
+ * no value is copied.
+ * 映射存储文件并索引其中的记录。只检查记录头和limb，不拷贝任何值。
+ *
+ * @param path
+ * @return true The store was opened. 存储已打开。
+ * @return false The file cannot be opened. 无法打开文件。
+ */
+bool BigIntStore::open(const string &path)
+{
+    this->records.clear();
+    if (!this->file.open(path))
+    {
+        return false;
+    }
+    const uint8_t *data = this->file.data();
+    size_t size = this->file.size();
+    if (size < BIGINT_STORE_HEADER_SIZE || memcmp(data, BIGINT_STORE_MAGIC, sizeof(BIGINT_STORE_MAGIC)) != 0)
+    {
+        this->file.close();
+        throw runtime_error("Not a BigInt store file: " + path);
+    }
+    uint64_t count = loadLittleEndian(data + 8);
+    size_t position = BIGINT_STORE_HEADER_SIZE;
+    // Every record takes at least one header, so a larger count is corrupt
+    // 每条记录至少占一个记录头，更大的个数说明文件已损坏
+    if (count > (size - position) / BIGINT_RECORD_HEADER_SIZE)
+    {
+        this->file.close();
+        throw runtime_error("Malformed BigInt store file: " + path);
+    }
+    this->records.resize(static_cast<size_t>(count));
+    for (BigIntView &record : this->records)
+    {
+        size_t consumed = 0;
+        if (!BigIntView::parse(data + position, size - position, record, consumed))
+        {
+            this->records.clear();
+            this->file.close();
+            throw runtime_error("Malformed BigInt store file: " + path);
+        }
+        position += consumed;
+    }
+    return true;
+}
+
+/**
+ * @brief Number of records.
+ * 记录个数。
+ *
+ * @return size_t
+ */
+size_t BigIntStore::count() const
+{
+    return this->records.size();
+}
+
+/**
+ * @brief View of a record, valid while the store stays open.
+ * 一条记录的视图，存储保持打开期间有效。
+ *
+ * @param index
+ * @return const BigIntView&
+ */
+const BigIntView &BigIntStore::operator[](size_t index) const
+{
+    return this->records[index];
+}
+
+/**
+ * @brief Writes values as a store file.
+ * 将各个值写为存储文件。
+ *
+ * @param path
+ * @param values
+ * @return true The file was written. 文件已写入。
+ * @return false
+ */
+bool BigIntStore::write(const string &path, const vector<BigInt> &values)
+{
+    vector<uint8_t> buffer(BIGINT_STORE_HEADER_SIZE);
+    memcpy(buffer.data(), BIGINT_STORE_MAGIC, sizeof(BIGINT_STORE_MAGIC));
+    storeLittleEndian(&buffer[8], values.size());
+    for (const BigInt &value : values)
+    {
+        serialize(value, buffer);
+    }
+    ofstream file(path, ios::binary);
+    if (!file.is_open())
+    {
+        return false;
+    }
+    file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<streamsize>(buffer.size()));
+    return static_cast<bool>(file);
+}
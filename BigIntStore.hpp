@@ -0,0 +1,91 @@
+#pragma once
+
+#include "BigInt.hpp"
+
+// Binary record format of one BigInt (all integers little-endian):
+// byte 0 sign (0 non-negative, 1 negative), bytes 1-7 reserved (0), bytes 8-15 number of limbs n,
+// then n limbs, one decimal digit per byte, least significant first
+// 单个 BigInt 的二进制记录格式（所有整数均为小端）：
+// 第0字节为符号（0为非负，1为负），第1-7字节保留（为0），第8-15字节为limb个数 n，
+// 之后是 n 个limb，每字节一位十进制数字，从最低位开始
+const size_t BIGINT_RECORD_HEADER_SIZE = 16;
+
+// Store file format: the 8-byte magic "BIGINTS1", the record count (8 bytes), then the records
+// 存储文件格式：8字节的魔数 "BIGINTS1"，记录个数（8字节），之后是各条记录
+const char BIGINT_STORE_MAGIC[8] = {'B', 'I', 'G', 'I', 'N', 'T', 'S', '1'};
+const size_t BIGINT_STORE_HEADER_SIZE = 16;
+
+// Size of the record of value 值的记录大小
+size_t serializedSize(const BigInt &value);
+// Appends the record of value to out 将值的记录追加到 out
+void serialize(const BigInt &value, vector<uint8_t> &out);
+// Reads one record, throws runtime_error if it is malformed 读取一条记录，格式错误时抛出 runtime_error
+BigInt deserialize(const uint8_t *data, size_t size, size_t *consumed = nullptr);
+
+// Zero-copy read-only view of one record, the limbs stay where they are 一条记录的零拷贝只读视图，limb 保留在原处
+class BigIntView
+{
+public:
+    // Empty view (0) 空视图（0）
+    BigIntView();
+    // Checks the record at data and views it, returns false if it is malformed 检查 data 处的记录并建立视图，格式错误时返回 false
+    static bool parse(const uint8_t *data, size_t size, BigIntView &view, size_t &consumed);
+
+    // Sign getter 符号
+    bool getSign() const;
+    // Number of limbs 位数
+    size_t size() const;
+    // Limb i, least significant first 第 i 位，从最低位开始
+    uint8_t operator[](size_t index) const;
+    // Copies the value into a BigInt 将值拷贝为 BigInt
+    BigInt toBigInt() const;
+    // Converts to a decimal string 转换为十进制字符串
+    string toString() const;
+
+private:
+    bool sign;
+    const uint8_t *limbs;
+    size_t length;
+};
+
+// Read-only memory mapping of a whole file 整个文件的只读内存映射
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // Maps the file, returns false if it cannot be opened 映射文件，无法打开时返回 false
+    bool open(const string &path);
+    // Unmaps the file 取消映射
+    void close();
+    const uint8_t *data() const;
+    size_t size() const;
+
+private:
+    const uint8_t *mapped;
+    size_t length;
+    // Used where mmap is not available 在没有 mmap 的平台上使用
+    vector<uint8_t> fallback;
+};
+
+// Read-only store of many records in one memory-mapped file 内存映射文件中的多条记录的只读存储
+class BigIntStore
+{
+public:
+    // Maps and indexes a store file, throws runtime_error if it is malformed 映射并索引存储文件，格式错误时抛出 runtime_error
+    bool open(const string &path);
+    // Number of records 记录个数
+    size_t count() const;
+    // View of record index, valid while the store is open 第 index 条记录的视图，存储打开期间有效
+    const BigIntView &operator[](size_t index) const;
+
+    // Writes values as a store file 将各个值写为存储文件
+    static bool write(const string &path, const vector<BigInt> &values);
+
+private:
+    MappedFile file;
+    vector<BigIntView> records;
+};
@@ -0,0 +1,527 @@
+#include "BigRational.hpp"
+
+using namespace std;
+
+/**
+ * @brief Default constructor, the value is 0.
+ * 默认构造函数，值为0。
+ */
+BigRational::BigRational() : numerator(0), denominator(1), reduced(true)
+{
+}
+
+/**
+ * @brief Constructor from a 64-bit integer.
+ * 由 64 位整数构造。
+ *
+ * @param value
+ */
+BigRational::BigRational(int64_t value) : numerator(value), denominator(1), reduced(true)
+{
+}
+
+/**
+ * @brief Constructor from a BigInt.
+ * 由 BigInt 构造。
+ *
+ * @param value
+ */
+BigRational::BigRational(const BigInt &value) : numerator(value), denominator(1), reduced(true)
+{
+}
+
+/**
+ * @brief Constructor from a numerator and a denominator. The fraction is not reduced here,
+ * the sign is moved to the numerator.
+ * 由分子和分母构造。此处不约分，符号移到分子上。
+ *
+ * @param numerator
+ * @param denominator Must not be 0. 不能为0。
+ */
+BigRational::BigRational(const BigInt &numerator, const BigInt &denominator)
+{
+    if (denominator == 0)
+    {
+        throw runtime_error("Division by zero");
+    }
+    if (denominator < 0)
+    {
+        assign(-numerator, -denominator, false);
+    }
+    else
+    {
+        assign(numerator, denominator, false);
+    }
+}
+
+/**
+ * @brief Total number of digits of the numerator and denominator.
+ * 分子和分母的总位数。
+ *
+ * @return size_t
+ */
+size_t BigRational::digitCount() const
+{
+    return this->numerator.size() + this->denominator.size();
+}
+
+/**
+ * @brief Stores a result. Integers and zero are always reduced, other unreduced results are reduced
+ * once they are past rational_reduce_threshold digits.
+ * 存储结果。整数和零总是已约分的，其他未约分的结果超过 rational_reduce_threshold 位时约分。
+ *
+ * @param numerator
+ * @param denominator Positive. 正数。
+ * @param reduced Whether the parts are known to be coprime. 是否已知两部分互素。
+ */
+void BigRational::assign(BigInt numerator, BigInt denominator, bool reduced)
+{
+    this->numerator = move(numerator);
+    this->denominator = move(denominator);
+    this->reduced = reduced || this->denominator == 1;
+    if (this->numerator == 0)
+    {
+        this->denominator = 1;
+        this->reduced = true;
+    }
+    if (!this->reduced && digitCount() > BigInt::getTuning().rationalReduceThreshold)
+    {
+        reduce();
+    }
+}
+
+/**
+ * @brief Divides the numerator and denominator by their GCD.
+ * 用分子和分母的最大公约数去除它们。
+ */
+void BigRational::reduce()
+{
+    if (this->reduced)
+    {
+        return;
+    }
+    BigInt divisor = gcd(this->numerator, this->denominator);
+    if (divisor != 1)
+    {
+        this->numerator /= divisor;
+        this->denominator /= divisor;
+    }
+    this->reduced = true;
+}
+
+/**
+ * @brief Copy of this value, reduced. Const methods read through it so that they never modify a value
+ * that other threads may be reading.
+ * 该值约分后的副本。const 方法通过它读取，因此不会修改其他线程可能正在读取的值。
+ *
+ * @return BigRational
+ */
+BigRational BigRational::reducedCopy() const
+{
+    BigRational copy = *this;
+    copy.reduce();
+    return copy;
+}
+
+/**
+ * @brief Whether the numerator and denominator are known to be coprime.
+ * 是否已知分子和分母互素。
+ *
+ * @return true
+ * @return false
+ */
+bool BigRational::isReduced() const
+{
+    return this->reduced;
+}
+
+/**
+ * @brief Adds or subtracts rhs. Equal denominators are added directly. Large operands are reduced and use
+ * g = gcd(b, d), a/b + c/d = (a(d/g) + c(b/g)) / (b/g * d), and only the gcd of that numerator with g
+ * is left to cancel, so the result stays reduced without a GCD of the full product.
+ * Small operands are cross-multiplied and reduced later.
+ * 加上或减去 rhs。分母相同时直接相加。较大的操作数先约分，再使用 g = gcd(b, d)，
+ * a/b + c/d = (a(d/g) + c(b/g)) / (b/g * d)，只需再约去该分子与 g 的公约数，
+ * 结果无需对整个乘积求 GCD 就保持约分。较小的操作数交叉相乘，之后再约分。
+ *
+ * @param rhs May be this. 可以是 this。
+ * @param subtract true to subtract. true 表示相减。
+ */
+void BigRational::addSigned(const BigRational &rhs, bool subtract)
+{
+    // Past the threshold, reducing the operands costs less than reducing the result
+    // 超过阈值时，约分操作数比约分结果代价更小
+    bool large = digitCount() + rhs.digitCount() > BigInt::getTuning().rationalReduceThreshold;
+    // rhs is const, an unreduced rhs is reduced in a copy. When rhs is this, reducing this reduces rhs too
+    // rhs 是 const，未约分的 rhs 在副本中约分。rhs 是 this 时，约分 this 也就约分了 rhs
+    BigRational reducedRhs;
+    const BigRational *source = &rhs;
+    if (large)
+    {
+        reduce();
+        if (!rhs.reduced)
+        {
+            reducedRhs = rhs.reducedCopy();
+            source = &reducedRhs;
+        }
+    }
+    const BigInt &a = this->numerator;
+    const BigInt &b = this->denominator;
+    const BigInt c = subtract ? -source->numerator : source->numerator;
+    const BigInt &d = source->denominator;
+
+    if (b == d)
+    {
+        // Integers stay integers, other sums may gain a common factor
+        // 整数相加仍为整数，其他情况的和可能产生公因子
+        assign(a + c, b, b == 1);
+        return;
+    }
+    if (large)
+    {
+        BigInt divisor = gcd(b, d);
+        if (divisor == 1)
+        {
+            BigInt sum = a * d;
+            addmul(sum, c, b);
+            assign(move(sum), b * d, true);
+            return;
+        }
+        BigInt bQuotient = b / divisor;
+        BigInt sum = a * (d / divisor);
+        addmul(sum, c, bQuotient);
+        BigInt common = gcd(sum, divisor);
+        if (common == 1)
+        {
+            assign(move(sum), bQuotient * d, true);
+        }
+        else
+        {
+            assign(sum / common, bQuotient * (d / common), true);
+        }
+        return;
+    }
+    BigInt sum = a * d;
+    addmul(sum, c, b);
+    assign(move(sum), b * d, false);
+}
+
+/**
+ * @brief Multiplies by numerator / denominator. With large operands, both are reduced and the gcd of each numerator
+ * with the other denominator is cancelled before multiplying (cross-cancellation). These gcds are taken
+ * on the operands, which are much smaller than the product, and the result is reduced.
+ * Otherwise the parts are multiplied and reduced later.
+ * 乘以 numerator / denominator。操作数较大时，先约分两者，再约去每个分子与另一个分母的公约数再相乘（交叉约分）。
+ * 这些 gcd 在比乘积小得多的操作数上计算，且结果是已约分的。否则直接相乘，之后再约分。
+ *
+ * @param numerator
+ * @param denominator Positive. 正数。
+ * @param rhsReduced Whether numerator and denominator are coprime. numerator 和 denominator 是否互素。
+ */
+void BigRational::multiply(BigInt numerator, BigInt denominator, bool rhsReduced)
+{
+    if (digitCount() + numerator.size() + denominator.size() > BigInt::getTuning().rationalReduceThreshold)
+    {
+        reduce();
+        if (!rhsReduced)
+        {
+            BigInt divisor = gcd(numerator, denominator);
+            numerator /= divisor;
+            denominator /= divisor;
+        }
+        BigInt first = gcd(this->numerator, denominator);
+        BigInt second = gcd(numerator, this->denominator);
+        assign((this->numerator / first) * (numerator / second), (this->denominator / second) * (denominator / first), true);
+        return;
+    }
+    assign(this->numerator * numerator, this->denominator * denominator, this->reduced && rhsReduced && this->denominator == 1 && denominator == 1);
+}
+
+/**
+ * @brief += operator.
+ * += 运算符。
+ *
+ * @param rhs
+ * @return BigRational&
+ */
+BigRational &BigRational::operator+=(const BigRational &rhs)
+{
+    addSigned(rhs, false);
+    return *this;
+}
+
+/**
+ * @brief -= operator.
+ * -= 运算符。
+ *
+ * @param rhs
+ * @return BigRational&
+ */
+BigRational &BigRational::operator-=(const BigRational &rhs)
+{
+    addSigned(rhs, true);
+    return *this;
+}
+
+/**
+ * @brief *= operator.
+ * *= 运算符。
+ *
+ * @param rhs
+ * @return BigRational&
+ */
+BigRational &BigRational::operator*=(const BigRational &rhs)
+{
+    // The parts are passed by value, rhs may be this
+    // 两部分按值传递，rhs 可能是 this
+    multiply(rhs.numerator, rhs.denominator, rhs.reduced);
+    return *this;
+}
+
+/**
+ * @brief /= operator, multiplies by the reciprocal.
+ * /= 运算符，乘以倒数。
+ *
+ * @param rhs
+ * @return BigRational&
+ */
+BigRational &BigRational::operator/=(const BigRational &rhs)
+{
+    if (rhs.numerator == 0)
+    {
+        throw runtime_error("Division by zero");
+    }
+    // The reciprocal keeps the denominator positive
+    // 倒数保持分母为正
+    bool negative = rhs.numerator < 0;
+    BigInt numerator = negative ? -rhs.denominator : rhs.denominator;
+    BigInt denominator = negative ? -rhs.numerator : rhs.numerator;
+    multiply(numerator, denominator, rhs.reduced);
+    return *this;
+}
+
+/**
+ * @brief Negation operator.
+ * 负号运算符。
+ *
+ * @return BigRational
+ */
+BigRational BigRational::operator-() const
+{
+    BigRational result = *this;
+    result.numerator = -result.numerator;
+    return result;
+}
+
+/**
+ * @brief == operator. Reduced fractions are equal only when their parts are equal.
+ * == 运算符。已约分的分数只有在各部分相等时才相等。
+ *
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigRational::operator==(const BigRational &rhs) const
+{
+    if (this->reduced && rhs.reduced)
+    {
+        return this->numerator == rhs.numerator && this->denominator == rhs.denominator;
+    }
+    if (this->numerator.getSign() != rhs.numerator.getSign())
+    {
+        return false;
+    }
+    return this->numerator * rhs.denominator == rhs.numerator * this->denominator;
+}
+
+/**
+ * @brief != operator, implemented as !(==).
+ * != 运算符，通过 !(==) 实现。
+ *
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigRational::operator!=(const BigRational &rhs) const
+{
+    return !(*this == rhs);
+}
+
+/**
+ * @brief < operator. Compares the signs, then cross-multiplies, the denominators are positive.
+ * < 运算符。先比较符号，再交叉相乘，分母为正。
+ *
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigRational::operator<(const BigRational &rhs) const
+{
+    if (this->numerator.getSign() != rhs.numerator.getSign())
+    {
+        return rhs.numerator.getSign();
+    }
+    if (this->denominator == rhs.denominator)
+    {
+        return this->numerator < rhs.numerator;
+    }
+    return this->numerator * rhs.denominator < rhs.numerator * this->denominator;
+}
+
+/**
+ * @brief > operator, implemented as rhs < this.
+ * > 运算符，通过 rhs < this 实现。
+ *
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigRational::operator>(const BigRational &rhs) const
+{
+    return rhs < *this;
+}
+
+/**
+ * @brief <= operator, implemented as !(>).
+ * <= 运算符，通过 !(>) 实现。
+ *
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigRational::operator<=(const BigRational &rhs) const
+{
+    return !(*this > rhs);
+}
+
+/**
+ * @brief >= operator, implemented as !(<).
+ * >= 运算符，通过 !(<) 实现。
+ *
+ * @param rhs
+ * @return true
+ * @return false
+ */
+bool BigRational::operator>=(const BigRational &rhs) const
+{
+    return !(*this < rhs);
+}
+
+/**
+ * @brief Output operator, prints the reduced fraction. An unreduced value is printed through a reduced copy.
+ * 输出运算符，输出约分后的分数。未约分的值通过约分后的副本输出。
+ *
+ * @param os
+ * @param value
+ * @return ostream&
+ */
+ostream &operator<<(ostream &os, const BigRational &value)
+{
+    if (!value.reduced)
+    {
+        return os << value.reducedCopy();
+    }
+    os << value.numerator;
+    if (value.denominator != 1)
+    {
+        os << '/' << value.denominator;
+    }
+    return os;
+}
+
+/**
+ * @brief Converts the reduced fraction to a string, an unreduced value is reduced in a copy.
+ * 将约分后的分数转换为字符串，未约分的值在副本中约分。
+ *
+ * @return string
+ */
+string BigRational::toString() const
+{
+    if (!this->reduced)
+    {
+        return reducedCopy().toString();
+    }
+    if (this->denominator == 1)
+    {
+        return this->numerator.toString();
+    }
+    return this->numerator.toString() + "/" + this->denominator.toString();
+}
+
+/**
+ * @brief Numerator of the reduced fraction.
+ * 约分后分数的分子。
+ *
+ * @return BigInt
+ */
+BigInt BigRational::getNumerator() const
+{
+    return this->reduced ? this->numerator : reducedCopy().numerator;
+}
+
+/**
+ * @brief Denominator of the reduced fraction, positive.
+ * 约分后分数的分母，为正。
+ *
+ * @return BigInt
+ */
+BigInt BigRational::getDenominator() const
+{
+    return this->reduced ? this->denominator : reducedCopy().denominator;
+}
+
+/**
+ * @brief + operator, implemented using +=.
+ * + 运算符，通过 += 实现。
+ *
+ * @param lhs
+ * @param rhs
+ * @return BigRational
+ */
+BigRational operator+(BigRational lhs, const BigRational &rhs)
+{
+    lhs += rhs;
+    return lhs;
+}
+
+/**
+ * @brief - operator, implemented using -=.
+ * - 运算符，通过 -= 实现。
+ *
+ * @param lhs
+ * @param rhs
+ * @return BigRational
+ */
+BigRational operator-(BigRational lhs, const BigRational &rhs)
+{
+    lhs -= rhs;
+    return lhs;
+}
+
+/**
+ * @brief * operator, implemented using *=.
+ * * 运算符，通过 *= 实现。
+ *
+ * @param lhs
+ * @param rhs
+ * @return BigRational
+ */
+BigRational operator*(BigRational lhs, const BigRational &rhs)
+{
+    lhs *= rhs;
+    return lhs;
+}
+
+/**
+ * @brief / operator, implemented using /=.
+ * / 运算符，通过 /= 实现。
+ *
+ * @param lhs
+ * @param rhs
+ * @return BigRational
+ */
+BigRational operator/(BigRational lhs, const BigRational &rhs)
+{
+    lhs /= rhs;
+    return lhs;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "BigInt.hpp"
+
+// Exact fraction of two BigInts. The GCD reduction is delayed until the numerator and denominator grow past
+// rational_reduce_threshold digits or the value is printed, reduced operands are combined with cross-cancellation
+// 两个 BigInt 组成的精确分数。GCD 约分推迟到分子和分母超过 rational_reduce_threshold 位或输出时才进行，
+// 已约分的操作数通过交叉约分组合
+class BigRational
+{
+public:
+    // Constructors, the default value is 0 构造函数，默认值为0
+    BigRational();
+    BigRational(int64_t value);
+    BigRational(const BigInt &value);
+    // Throws runtime_error when the denominator is 0 分母为0时抛出 runtime_error
+    BigRational(const BigInt &numerator, const BigInt &denominator);
+
+    // Compound assignment operators 复合赋值运算符
+    BigRational &operator+=(const BigRational &rhs);
+    BigRational &operator-=(const BigRational &rhs);
+    BigRational &operator*=(const BigRational &rhs);
+    // Throws runtime_error when rhs is 0 rhs 为0时抛出 runtime_error
+    BigRational &operator/=(const BigRational &rhs);
+
+    // Negation operator 负号运算符
+    BigRational operator-() const;
+
+    // Comparison operators, by cross-multiplication when the operands are not reduced 比较运算符，操作数未约分时交叉相乘比较
+    bool operator==(const BigRational &rhs) const;
+    bool operator!=(const BigRational &rhs) const;
+    bool operator<(const BigRational &rhs) const;
+    bool operator>(const BigRational &rhs) const;
+    bool operator<=(const BigRational &rhs) const;
+    bool operator>=(const BigRational &rhs) const;
+
+    // Output of the reduced fraction, an unreduced value is reduced in a copy 输出约分后的分数，未约分的值在副本中约分
+    friend ostream &operator<<(ostream &os, const BigRational &value);
+    // "numerator/denominator", or only the numerator when the denominator is 1 "分子/分母"，分母为1时只输出分子
+    string toString() const;
+
+    // Parts of the reduced fraction, the denominator is positive. Like the output, these never modify the value,
+    // so call reduce() first to avoid reducing a copy on every call
+    // 约分后的分子和分母，分母为正。与输出一样不会修改该值，因此应先调用 reduce()，避免每次调用都约分一个副本
+    BigInt getNumerator() const;
+    BigInt getDenominator() const;
+    // Divides the numerator and denominator by their GCD 用分子和分母的最大公约数去除它们
+    void reduce();
+    // Whether the numerator and denominator are known to be coprime 是否已知分子和分母互素
+    bool isReduced() const;
+
+private:
+    // The denominator is always positive, the sign is in the numerator 分母始终为正，符号在分子上
+    BigInt numerator;
+    BigInt denominator;
+    bool reduced;
+    // Copy of this value, reduced 该值约分后的副本
+    BigRational reducedCopy() const;
+    // Total number of digits of the numerator and denominator 分子和分母的总位数
+    size_t digitCount() const;
+    // Stores a result, reducing it if it is past the threshold 存储结果，超过阈值时约分
+    void assign(BigInt numerator, BigInt denominator, bool reduced);
+    // Adds or subtracts rhs 加上或减去 rhs
+    void addSigned(const BigRational &rhs, bool subtract);
+    // Multiplies by numerator / denominator, the denominator is positive 乘以 numerator / denominator，分母为正
+    void multiply(BigInt numerator, BigInt denominator, bool rhsReduced);
+};
+
+// Arithmetic operators 算术运算符
+BigRational operator+(BigRational lhs, const BigRational &rhs);
+BigRational operator-(BigRational lhs, const BigRational &rhs);
+BigRational operator*(BigRational lhs, const BigRational &rhs);
+BigRational operator/(BigRational lhs, const BigRational &rhs);
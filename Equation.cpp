@@ -0,0 +1,367 @@
+#include "Equation.hpp"
+#include "BigIntAccumulator.hpp"
+#include <cctype>
+
+using namespace std;
+
+/**
+ * @brief Whether the equation was parsed or evaluated.
+ * 算式是否已成功解析或求值。
+ *
+ * @return true No error. 没有错误。
+ * @return false
+ */
+bool EquationStatus::ok() const
+{
+    return this->error == EquationError::None;
+}
+
+/**
+ * @brief Text of the reason, the same wording the driver has always printed.
+ * 原因的文字描述，与驱动程序一直输出的措辞相同。
+ *
+ * @return const char*
+ */
+const char *EquationStatus::reason() const
+{
+    switch (this->error)
+    {
+    case EquationError::None:
+        return "No error";
+    case EquationError::EmptyLine:
+        return "Empty line";
+    case EquationError::IllegalOperator:
+        return "Illegal input or operator";
+    case EquationError::EmptyOperand:
+        return "Empty operand";
+    case EquationError::MissingNumber:
+        return "Invalid operand: '-' without number";
+    case EquationError::MissingHexNumber:
+        return "Invalid operand: '0x' without number";
+    case EquationError::LeadingZero:
+        return "Invalid operand: negative number starts with 0";
+    case EquationError::InvalidCharacter:
+        return "Invalid character in operand";
+    case EquationError::OperandCount:
+        return "Invalid number of operands";
+    }
+    return "Unknown error";
+}
+
+/**
+ * @brief Message with the position and the reason.
+ * 带位置和原因的信息。
+ *
+ * @return string
+ */
+string EquationStatus::message() const
+{
+    string text = "line " + to_string(this->line);
+    if (this->column != 0)
+    {
+        text += ", column " + to_string(this->column);
+    }
+    return text + ": " + this->reason();
+}
+
+/**
+ * @brief Builds a status.
+ * 构造状态。
+ *
+ * @param error
+ * @param line
+ * @param column 1-based, 0 for the whole line. 从1开始，0表示整行。
+ * @return EquationStatus
+ */
+static EquationStatus makeStatus(EquationError error, int line, size_t column)
+{
+    EquationStatus status;
+    status.error = error;
+    status.line = line;
+    status.column = column;
+    return status;
+}
+
+/**
+ * @brief Checks and converts one operand, text[begin, end).
+ * 检查并转换一个操作数，即 text[begin, end)。
+ *
+ * @param text The line. 输入行。
+ * @param begin Start of the operand. 操作数的起始位置。
+ * @param end End of the operand. 操作数的结束位置。
+ * @param lineNumber
+ * @param operands Receives the operand. 接收操作数。
+ * @return EquationStatus
+ */
+static EquationStatus parseOperand(const string &text, size_t begin, size_t end, int lineNumber, vector<BigInt> &operands)
+{
+    // Check for empty string.
+    // 检查是否为空字符串
+    if (begin == end)
+    {
+        return makeStatus(EquationError::EmptyOperand, lineNumber, begin + 1);
+    }
+
+    // Check for validity (only digits and an optional single negative sign).
+    // 检查合法性（仅数字和可选的单个负号）
+    bool isNegative = (text[begin] == '-');
+    size_t digitsStart = isNegative ? begin + 1 : begin;
+    if (digitsStart == end)
+    {
+        return makeStatus(EquationError::MissingNumber, lineNumber, begin + 1);
+    }
+    // Hexadecimal operand with a 0x prefix, converted without going through decimal.
+    // 带0x前缀的十六进制操作数，不经过十进制直接转换
+    if (end - digitsStart > 1 && text[digitsStart] == '0' && (text[digitsStart + 1] == 'x' || text[digitsStart + 1] == 'X'))
+    {
+        size_t hexStart = digitsStart + 2;
+        if (hexStart == end)
+        {
+            return makeStatus(EquationError::MissingHexNumber, lineNumber, begin + 1);
+        }
+        for (size_t i = hexStart; i < end; ++i)
+        {
+            if (!isxdigit(static_cast<unsigned char>(text[i])))
+            {
+                return makeStatus(EquationError::InvalidCharacter, lineNumber, i + 1);
+            }
+        }
+        operands.push_back(BigInt::fromString((isNegative ? "-" : "") + text.substr(hexStart, end - hexStart), 16));
+        return makeStatus(EquationError::None, lineNumber, 0);
+    }
+    if (isNegative && text[digitsStart] == '0')
+    {
+        // If the user inputs -0, treat it as 0.
+        // 如果用户输入了-0，则按照0来处理
+        if (end - digitsStart == 1)
+        {
+            operands.push_back(BigInt());
+            return makeStatus(EquationError::None, lineNumber, 0);
+        }
+        return makeStatus(EquationError::LeadingZero, lineNumber, begin + 1);
+    }
+    for (size_t i = digitsStart; i < end; ++i)
+    {
+        if (!isdigit(static_cast<unsigned char>(text[i])))
+        {
+            return makeStatus(EquationError::InvalidCharacter, lineNumber, i + 1);
+        }
+    }
+    // Initialize as a BigInt and store.
+    // 初始化为BigInt并储存
+    operands.push_back(BigInt(text.substr(begin, end - begin)));
+    return makeStatus(EquationError::None, lineNumber, 0);
+}
+
+/**
+ * @brief Parses one line, op(operand1,operand2,...), without throwing. Errors are returned as a
+ * status with the line, the column and the reason, so dirty input costs no exception unwinding.
+ * 不抛出异常地解析一行 op(operand1,operand2,...)。错误以带行号、列号和原因的状态返回，
+ * 因此有大量错误的输入也不需要异常展开的开销。
+ *
+ * @param text The line of input. 输入行。
+ * @param lineNumber The line number in the input file. 文件中的行号。
+ * @param equation Receives the equation when the status is ok. 状态为成功时接收算式。
+ * @return EquationStatus
+ */
+EquationStatus tryParse(const string &text, int lineNumber, Equation &equation)
+{
+    equation.operands.clear();
+    equation.line = lineNumber;
+    if (text.empty())
+    {
+        return makeStatus(EquationError::EmptyLine, lineNumber, 0);
+    }
+
+    // Operator name, everything before the opening parenthesis
+    // 运算符名称，即左括号之前的所有内容
+    size_t openPos = text.find('(');
+    if (openPos == string::npos)
+    {
+        return makeStatus(EquationError::IllegalOperator, lineNumber, 1);
+    }
+    if (text.back() != ')')
+    {
+        return makeStatus(EquationError::IllegalOperator, lineNumber, text.size());
+    }
+    equation.opName.assign(text, 0, openPos);
+    // Check for legality of the operator.
+    // 运算符合法性判断
+    const string &opName = equation.opName;
+    if (!(opName == "+" || opName == "-" || opName == "*" || opName == "sum" || opName == "isprime"))
+    {
+        return makeStatus(EquationError::IllegalOperator, lineNumber, 1);
+    }
+    // sum(...) is another name for the n-ary +
+    // sum(...) 是n元+的另一个名称
+    if (opName == "sum")
+    {
+        equation.op = '+';
+    }
+    else if (opName == "isprime")
+    {
+        equation.op = 'p';
+    }
+    else
+    {
+        equation.op = opName[0];
+    }
+
+    // Parse the comma-separated operands within the parentheses, a trailing comma is ignored.
+    // 解析括号内以逗号分隔的操作数，忽略末尾的逗号
+    size_t contentEnd = text.size() - 1;
+    size_t begin = openPos + 1;
+    while (begin < contentEnd)
+    {
+        size_t end = text.find(',', begin);
+        if (end == string::npos || end > contentEnd)
+        {
+            end = contentEnd;
+        }
+        EquationStatus status = parseOperand(text, begin, end, lineNumber, equation.operands);
+        if (!status.ok())
+        {
+            return status;
+        }
+        begin = end + 1;
+    }
+    return makeStatus(EquationError::None, lineNumber, 0);
+}
+
+/**
+ * @brief Checks the number of operands and computes the result, without throwing.
+ * 不抛出异常地检查操作数数量并计算结果。
+ *
+ * @param equation A parsed equation. 已解析的算式。
+ * @param result Receives the result when the status is ok. 状态为成功时接收结果。
+ * @return EquationStatus
+ */
+EquationStatus tryEvaluate(const Equation &equation, BigInt &result)
+{
+    const vector<BigInt> &operands = equation.operands;
+    size_t count = operands.size();
+    // Check the number of operands: * is binary, + takes two or more, sum one or more, - is unary or binary,
+    // isprime is unary.
+    // 检查操作数数量：*为二元，+接受两个或更多，sum接受一个或更多，-为一元或二元，isprime为一元
+    bool valid = false;
+    switch (equation.op)
+    {
+    case '*':
+        valid = count == 2;
+        break;
+    case '+':
+        valid = count >= (equation.opName == "sum" ? 1u : 2u);
+        break;
+    case '-':
+        valid = count == 1 || count == 2;
+        break;
+    case 'p':
+        valid = count == 1;
+        break;
+    default:
+        return makeStatus(EquationError::IllegalOperator, equation.line, 0);
+    }
+    if (!valid)
+    {
+        return makeStatus(EquationError::OperandCount, equation.line, 0);
+    }
+
+    // Execute the operation.
+    // 执行运算
+    switch (equation.op)
+    {
+    case '+':
+        if (count == 2)
+        {
+            add(result, operands[0], operands[1]);
+        }
+        // Bulk reductions use the accumulator, carries are resolved once at the end
+        // 批量求和使用累加器，只在最后处理一次进位
+        else
+        {
+            BigIntAccumulator accumulator;
+            for (const BigInt &operand : operands)
+            {
+                accumulator += operand;
+            }
+            result = accumulator.result();
+        }
+        break;
+    case '-':
+        if (count == 1)
+        {
+            result = -operands[0];
+        }
+        else
+        {
+            sub(result, operands[0], operands[1]);
+        }
+        break;
+    // isprime(a) is 1 when a is a probable prime, 0 otherwise
+    // a 可能是素数时 isprime(a) 为1，否则为0
+    case 'p':
+        result = operands[0].isProbablePrime() ? 1 : 0;
+        break;
+    default:
+        mul(result, operands[0], operands[1]);
+        break;
+    }
+    return makeStatus(EquationError::None, equation.line, 0);
+}
+
+/**
+ * @brief Throwing wrapper of tryParse for existing callers.
+ * 供已有调用者使用的 tryParse 抛出异常包装。
+ *
+ * @param text The line of input. 输入行。
+ * @param lineNumber The line number in the input file. 文件中的行号。
+ * @return Equation
+ */
+Equation parseEquation(const string &text, int lineNumber)
+{
+    Equation equation;
+    EquationStatus status = tryParse(text, lineNumber, equation);
+    if (!status.ok())
+    {
+        throw runtime_error(status.message());
+    }
+    return equation;
+}
+
+/**
+ * @brief Throwing wrapper of tryEvaluate for existing callers.
+ * 供已有调用者使用的 tryEvaluate 抛出异常包装。
+ *
+ * @param equation A parsed equation. 已解析的算式。
+ * @return BigInt
+ */
+BigInt evaluateEquation(const Equation &equation)
+{
+    BigInt result;
+    EquationStatus status = tryEvaluate(equation, result);
+    if (!status.ok())
+    {
+        throw runtime_error(status.message());
+    }
+    return result;
+}
+
+/**
+ * @brief Parses and evaluates an equation on another thread. The multiplication kernels check token
+ * at their safe points and report progress to it, and the loops of isprime check it too.
+ * 在另一个线程上解析并求值算式。乘法内核在安全点检查 token 并向其报告进度，isprime 的循环也会检查它。
+ *
+ * @param text The equation, in the input file syntax. 输入文件语法的算式。
+ * @param token Cancellation token shared with the caller. 与调用者共享的取消令牌。
+ * @return future<BigInt>
+ */
+future<BigInt> asyncEval(const string &text, const BigIntCancelToken &token)
+{
+    return async(launch::async, [text, token]()
+                 {
+        BigIntCancelScope scope(token);
+        token.check();
+        BigInt result = evaluateEquation(parseEquation(text, 1));
+        token.setProgress(1);
+        return result; });
+}
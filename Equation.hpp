@@ -0,0 +1,58 @@
+#pragma once
+
+#include "BigInt.hpp"
+
+// Reason an equation could not be parsed or evaluated 算式无法解析或求值的原因
+enum class EquationError
+{
+    None,
+    EmptyLine,
+    IllegalOperator,
+    EmptyOperand,
+    MissingNumber,
+    MissingHexNumber,
+    LeadingZero,
+    InvalidCharacter,
+    OperandCount
+};
+
+// Result of tryParse and tryEvaluate, reported without throwing tryParse 和 tryEvaluate 的结果，不通过异常报告
+struct EquationStatus
+{
+    EquationError error;
+    // Line number given to tryParse 传给 tryParse 的行号
+    int line;
+    // 1-based column of the error, 0 when it concerns the whole line 错误所在的列（从1开始），涉及整行时为0
+    size_t column;
+
+    bool ok() const;
+    // Text of the reason 原因的文字描述
+    const char *reason() const;
+    // "line N, column C: reason" "line N, column C: 原因"
+    string message() const;
+};
+
+// Parsed equation: op(operand1,operand2,...) 解析后的算式：op(operand1,operand2,...)
+struct Equation
+{
+    // Operation name: +, -, *, sum or isprime 运算名称：+、-、*、sum或isprime
+    string opName;
+    // Operator, '+' for sum and 'p' for isprime 运算符，sum 为 '+'，isprime 为 'p'
+    char op;
+    vector<BigInt> operands;
+    // Line number in the input 输入中的行号
+    int line;
+};
+
+// Non-throwing API, the status tells whether equation / result were filled 不抛出异常的接口，由状态说明 equation / result 是否已填写
+EquationStatus tryParse(const string &text, int lineNumber, Equation &equation);
+EquationStatus tryEvaluate(const Equation &equation, BigInt &result);
+
+// Throwing wrappers, errors become runtime_error with the status message 抛出异常的包装，错误转换为带状态信息的 runtime_error
+Equation parseEquation(const string &text, int lineNumber);
+BigInt evaluateEquation(const Equation &equation);
+
+// Parses and evaluates on another thread under token, the future throws runtime_error for a bad equation
+// and BigIntCancelled when the token is cancelled or expires
+// 在另一个线程上以 token 解析并求值，算式错误时 future 抛出 runtime_error，令牌被取消或过期时抛出 BigIntCancelled
+future<BigInt> asyncEval(const string &text, const BigIntCancelToken &token = BigIntCancelToken());
@@ -0,0 +1,408 @@
+#include "EvalServer.hpp"
+#include "BigInt.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define EVAL_SERVER_SUPPORTED 1
+#endif
+
+// Writing to a closed connection must not raise SIGPIPE
+// 向已关闭的连接写入时不能触发 SIGPIPE
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+using namespace std;
+
+/**
+ * @brief Size of the buffer each connection reads into.
+ * 每个连接读取时使用的缓冲区大小。
+ */
+static const size_t READ_BUFFER_SIZE = 1 << 16;
+
+/**
+ * @brief Longest line a connection may send. A client that sends more without a newline is answered with
+ * an error and disconnected, so one connection cannot make the server buffer without bound.
+ * 一个连接可以发送的最长行。客户端发送更多内容却没有换行时，会收到错误并被断开连接，
+ * 因此单个连接无法让服务器无限制地缓冲。
+ */
+static const size_t MAX_LINE_LENGTH = 1 << 26;
+
+/**
+ * @brief Starts the worker pool.
+ * 启动工作线程池。
+ *
+ * @param handler Evaluates one request. 对一个请求求值。
+ * @param workers Number of worker threads, 0 for one per hardware thread. 工作线程数，0表示每个硬件线程一个。
+ * @param maxBatch Most requests a worker takes from the queue at once. 工作线程一次从队列取出的最多请求数。
+ */
+EvalServer::EvalServer(Handler handler, size_t workers, size_t maxBatch)
+    : handler(std::move(handler)), maxBatch(max<size_t>(maxBatch, 1)), listenFd(-1), stopping(false), finished(false),
+      started(chrono::steady_clock::now()), requestCount(0), errorCount(0), batchCount(0), totalLatencyNs(0),
+      maxLatencyNs(0)
+{
+    if (workers == 0)
+    {
+        workers = max<unsigned>(thread::hardware_concurrency(), 1);
+    }
+    for (size_t i = 0; i < workers; ++i)
+    {
+        this->workers.emplace_back(&EvalServer::workerLoop, this);
+    }
+}
+
+/**
+ * @brief Stops the server, waits for the connections to close and joins the workers.
+ * 停止服务器，等待连接关闭并结束工作线程。
+ */
+EvalServer::~EvalServer()
+{
+    this->stop();
+    {
+        unique_lock<mutex> lock(this->connectionMutex);
+        this->connectionsClosed.wait(lock, [this]()
+                                     { return this->connections.empty(); });
+    }
+    {
+        lock_guard<mutex> lock(this->queueMutex);
+        this->finished = true;
+    }
+    this->queueReady.notify_all();
+    for (thread &worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Binds a Unix domain socket at the path, replacing a stale socket file, and listens on it.
+ * 在路径上绑定 Unix 域套接字（替换遗留的套接字文件）并开始监听。
+ *
+ * @param socketPath
+ * @return true The server is listening. 服务器正在监听。
+ * @return false The socket could not be created or bound. 无法创建或绑定套接字。
+ */
+bool EvalServer::listen(const string &socketPath)
+{
+#ifdef EVAL_SERVER_SUPPORTED
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path))
+    {
+        return false;
+    }
+    strcpy(address.sun_path, socketPath.c_str());
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+    unlink(socketPath.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || ::listen(fd, SOMAXCONN) != 0)
+    {
+        close(fd);
+        return false;
+    }
+    this->listenFd = fd;
+    this->socketPath = socketPath;
+    return true;
+#else
+    (void)socketPath;
+    return false;
+#endif
+}
+
+/**
+ * @brief Accepts connections until stop() is called, each connection is read by its own thread.
+ * 接受连接直到调用 stop()，每个连接由各自的线程读取。
+ */
+void EvalServer::run()
+{
+#ifdef EVAL_SERVER_SUPPORTED
+    while (!this->stopping)
+    {
+        int fd = accept(this->listenFd, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        {
+            lock_guard<mutex> lock(this->connectionMutex);
+            if (this->stopping)
+            {
+                close(fd);
+                break;
+            }
+            this->connections.insert(fd);
+        }
+        thread(&EvalServer::serveConnection, this, fd).detach();
+    }
+#endif
+}
+
+/**
+ * @brief Stops accepting connections and shuts the open ones down, so their threads finish.
+ * 停止接受连接并关闭已打开的连接，使其线程结束。
+ */
+void EvalServer::stop()
+{
+#ifdef EVAL_SERVER_SUPPORTED
+    if (this->stopping.exchange(true))
+    {
+        return;
+    }
+    if (this->listenFd >= 0)
+    {
+        shutdown(this->listenFd, SHUT_RDWR);
+        close(this->listenFd);
+        this->listenFd = -1;
+        unlink(this->socketPath.c_str());
+    }
+    lock_guard<mutex> lock(this->connectionMutex);
+    for (int fd : this->connections)
+    {
+        shutdown(fd, SHUT_RDWR);
+    }
+#else
+    this->stopping = true;
+#endif
+}
+
+/**
+ * @brief Counters since the server started: requests, errors, batches, mean and maximum latency
+ * from receiving a request to finishing it, and throughput, then the bytes held by live BigInts.
+ * 服务器启动以来的计数：请求数、错误数、批次数、从收到请求到完成的平均和最大延迟，以及吞吐量，
+ * 然后是存活的 BigInt 占用的字节数。
+ *
+ * @return string
+ */
+string EvalServer::stats() const
+{
+    uint64_t requests = this->requestCount;
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - this->started).count();
+    ostringstream os;
+    os << "requests " << requests << " errors " << this->errorCount << " batches " << this->batchCount
+       << " mean_latency_us " << (requests == 0 ? 0.0 : this->totalLatencyNs / 1e3 / requests)
+       << " max_latency_us " << this->maxLatencyNs / 1e3 << " requests_per_second " << requests / seconds
+       << " live_bytes " << BigInt::liveBytes();
+    return os.str();
+}
+
+/**
+ * @brief Worker thread: takes up to maxBatch requests per lock of the queue, evaluates them
+ * and records their latency. Exceptions from the handler are counted as errors.
+ * 工作线程：每次锁定队列时最多取出 maxBatch 个请求，对其求值并记录延迟。处理函数抛出的异常计为错误。
+ */
+void EvalServer::workerLoop()
+{
+    vector<Request *> batch;
+    while (true)
+    {
+        batch.clear();
+        {
+            unique_lock<mutex> lock(this->queueMutex);
+            this->queueReady.wait(lock, [this]()
+                                  { return !this->queue.empty() || this->finished; });
+            if (this->queue.empty())
+            {
+                return;
+            }
+            while (!this->queue.empty() && batch.size() < this->maxBatch)
+            {
+                batch.push_back(this->queue.front());
+                this->queue.pop_front();
+            }
+        }
+        ++this->batchCount;
+        for (Request *request : batch)
+        {
+            // An exception from one request, such as bad_alloc for a huge product, becomes its error response
+            // instead of ending the server, and the waiting connection is always released
+            // 单个请求抛出的异常（例如巨大乘积引起的 bad_alloc）变为该请求的错误响应，而不会终止服务器，
+            // 等待中的连接总会被释放
+            bool ok = false;
+            try
+            {
+                ok = this->handler(request->line, request->number, request->response);
+            }
+            catch (const exception &e)
+            {
+                request->response = "Error in line " + to_string(request->number) + ": " + e.what();
+            }
+            catch (...)
+            {
+                request->response = "Error in line " + to_string(request->number) + ": unknown exception";
+            }
+            if (!ok)
+            {
+                ++this->errorCount;
+            }
+            uint64_t latency = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - request->received).count();
+            this->totalLatencyNs += latency;
+            uint64_t previous = this->maxLatencyNs;
+            while (latency > previous && !this->maxLatencyNs.compare_exchange_weak(previous, latency))
+            {
+            }
+            ++this->requestCount;
+            request->done.set_value();
+        }
+    }
+}
+
+/**
+ * @brief Queues requests for the workers and waits until each one is done.
+ * 将请求加入工作线程的队列，并等待每个请求完成。
+ *
+ * @param requests
+ */
+void EvalServer::submit(vector<Request *> &requests)
+{
+    if (requests.empty())
+    {
+        return;
+    }
+    vector<future<void>> done;
+    done.reserve(requests.size());
+    {
+        lock_guard<mutex> lock(this->queueMutex);
+        for (Request *request : requests)
+        {
+            done.push_back(request->done.get_future());
+            this->queue.push_back(request);
+        }
+    }
+    if (requests.size() == 1)
+    {
+        this->queueReady.notify_one();
+    }
+    else
+    {
+        this->queueReady.notify_all();
+    }
+    for (future<void> &result : done)
+    {
+        result.wait();
+    }
+}
+
+/**
+ * @brief Connection thread. All complete lines of one read are submitted together, and their
+ * responses are written back in order with one write. The line "stats" returns the counters and
+ * "quit" closes the connection, as does a line longer than MAX_LINE_LENGTH.
+ * 连接线程。一次读取到的所有完整行一起提交，其响应按顺序通过一次写入返回。
+ * "stats" 行返回计数，"quit" 行关闭连接，超过 MAX_LINE_LENGTH 的行也会关闭连接。
+ *
+ * @param fd Connected socket. 已连接的套接字。
+ */
+void EvalServer::serveConnection(int fd)
+{
+#ifdef EVAL_SERVER_SUPPORTED
+    vector<char> buffer(READ_BUFFER_SIZE);
+    string pending;
+    string output;
+    uint64_t lineNumber = 1;
+    bool open = true;
+    while (open)
+    {
+        ssize_t received = recv(fd, buffer.data(), buffer.size(), 0);
+        if (received < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (received <= 0)
+        {
+            break;
+        }
+        pending.append(buffer.data(), static_cast<size_t>(received));
+        auto now = chrono::steady_clock::now();
+
+        // Split off the complete lines, a partial line waits for the next read
+        // 拆分出完整的行，不完整的行等待下一次读取
+        deque<Request> requests;
+        vector<Request *> work;
+        size_t begin = 0;
+        size_t end;
+        while ((end = pending.find('\n', begin)) != string::npos)
+        {
+            string line = pending.substr(begin, end - begin);
+            begin = end + 1;
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if (line == "quit")
+            {
+                open = false;
+                break;
+            }
+            requests.emplace_back();
+            Request &request = requests.back();
+            // Control lines are answered directly, everything else goes to the workers
+            // 控制行直接回答，其余的交给工作线程
+            if (line == "stats")
+            {
+                request.response = this->stats();
+                continue;
+            }
+            request.line = std::move(line);
+            request.number = lineNumber++;
+            request.received = now;
+            work.push_back(&request);
+        }
+        pending.erase(0, begin);
+        bool tooLong = open && pending.size() > MAX_LINE_LENGTH;
+        this->submit(work);
+
+        output.clear();
+        for (const Request &request : requests)
+        {
+            output += request.response;
+            output += '\n';
+        }
+        if (tooLong)
+        {
+            output += "Error: line longer than " + to_string(MAX_LINE_LENGTH) + " bytes\n";
+            open = false;
+        }
+        for (size_t sent = 0; sent < output.size();)
+        {
+            ssize_t written = send(fd, output.data() + sent, output.size() - sent, SEND_FLAGS);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                open = false;
+                break;
+            }
+            sent += static_cast<size_t>(written);
+        }
+    }
+    // Leave the set before closing, otherwise stop() could shut down the descriptor after accept() reused it.
+    // The server may be gone once stop() sees the set empty, so only the descriptor is touched afterwards
+    // 先离开集合再关闭，否则 accept() 复用该描述符后 stop() 可能会关闭它。
+    // stop() 看到集合为空后服务器可能已不存在，因此之后只操作该描述符
+    {
+        lock_guard<mutex> lock(this->connectionMutex);
+        this->connections.erase(fd);
+        this->connectionsClosed.notify_all();
+    }
+    close(fd);
+#else
+    (void)fd;
+#endif
+}
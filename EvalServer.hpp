@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Long-running evaluation server on a Unix domain socket. Clients send one request per line and get
+// one response line per request, in order. Requests from all connections are queued and taken in
+// batches by a pool of worker threads, which keep their buffers warm between requests.
+// 基于 Unix 域套接字的常驻求值服务器。客户端每行发送一个请求，并按顺序为每个请求收到一行响应。
+// 所有连接的请求进入同一队列，由工作线程池成批取出，工作线程在请求之间保持其缓冲区。
+class EvalServer
+{
+public:
+    // Evaluates one request line into its response (without the newline), returns false for an error
+    // 将一行请求求值为响应（不含换行符），出错时返回 false
+    using Handler = function<bool(const string &request, uint64_t requestNumber, string &response)>;
+
+    // workers 0 means one per hardware thread workers 为0表示每个硬件线程一个
+    explicit EvalServer(Handler handler, size_t workers = 0, size_t maxBatch = 64);
+    ~EvalServer();
+    EvalServer(const EvalServer &) = delete;
+    EvalServer &operator=(const EvalServer &) = delete;
+
+    // Binds and listens on the socket path, returns false on failure 在套接字路径上绑定并监听，失败时返回 false
+    bool listen(const string &socketPath);
+    // Accepts connections until stop() is called 接受连接直到调用 stop()
+    void run();
+    // Stops accepting and closes all connections 停止接受连接并关闭所有连接
+    void stop();
+    // Throughput and latency counters as one line 一行文字形式的吞吐量和延迟计数
+    string stats() const;
+
+private:
+    // One request line waiting for a worker 等待工作线程处理的一行请求
+    struct Request
+    {
+        string line;
+        uint64_t number;
+        string response;
+        chrono::steady_clock::time_point received;
+        promise<void> done;
+    };
+
+    // Takes batches of requests from the queue and evaluates them 从队列中成批取出请求并求值
+    void workerLoop();
+    // Reads requests from one connection and writes the responses back 从一个连接读取请求并写回响应
+    void serveConnection(int fd);
+    // Queues the requests and waits until all are done 将请求加入队列并等待全部完成
+    void submit(vector<Request *> &requests);
+
+    Handler handler;
+    size_t maxBatch;
+    string socketPath;
+    int listenFd;
+    atomic<bool> stopping;
+    // Set once the connections are closed, the workers then exit 连接全部关闭后置位，随后工作线程退出
+    bool finished;
+
+    // Request queue shared by the workers 工作线程共享的请求队列
+    mutex queueMutex;
+    condition_variable queueReady;
+    deque<Request *> queue;
+    vector<thread> workers;
+
+    // Open connections, closed by stop() 已打开的连接，由 stop() 关闭
+    mutex connectionMutex;
+    condition_variable connectionsClosed;
+    set<int> connections;
+
+    // Counters 计数
+    chrono::steady_clock::time_point started;
+    atomic<uint64_t> requestCount;
+    atomic<uint64_t> errorCount;
+    atomic<uint64_t> batchCount;
+    atomic<uint64_t> totalLatencyNs;
+    atomic<uint64_t> maxLatencyNs;
+};
@@ -0,0 +1,107 @@
+#include "BigInt.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace std;
+
+/**
+ * @brief Generates a random string of digits in the given base, without a leading zero.
+ * 生成指定进制的随机数字字符串，最高位不为0。
+ *
+ * @param length Number of characters.字符数。
+ * @param base 10 or 16.10或16。
+ * @param rng Random number generator.随机数生成器。
+ * @return string
+ */
+string randomDigits(size_t length, int base, mt19937_64 &rng)
+{
+    const char *characters = "0123456789abcdef";
+    uniform_int_distribution<int> digit(0, base - 1);
+    string value;
+    value.reserve(length);
+    value.push_back(characters[1 + digit(rng) % (base - 1)]);
+    for (size_t i = 1; i < length; ++i)
+    {
+        value.push_back(characters[digit(rng)]);
+    }
+    return value;
+}
+
+/**
+ * @brief Measures the time of one call of body.
+ * 测量一次调用 body 的耗时。
+ *
+ * @param body
+ * @return double Seconds.秒数。
+ */
+template <typename Body>
+double timeOnce(Body body)
+{
+    auto start = chrono::steady_clock::now();
+    body();
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * @brief Compares the div_1 passes of toString(16) with its divide-and-conquer split, then measures the
+ * conversions with 1, 2, 4, ... threads up to the number of hardware threads, and prints the time and speedup of each.
+ * Usage: bench_convert [decimal digits] [hexadecimal digits], the defaults are 50000000 and 200000.
+ * 先比较 toString(16) 的 div_1 遍历与分治拆分，再分别用1、2、4……直到硬件线程数个线程测量各个转换，并输出耗时和加速比。
+ * 用法：bench_convert [十进制位数] [十六进制位数]，默认为 50000000 和 200000。
+ */
+int main(int argc, char *argv[])
+{
+    size_t decimalLength = argc > 1 ? strtoull(argv[1], nullptr, 10) : 50000000;
+    size_t hexLength = argc > 2 ? strtoull(argv[2], nullptr, 10) : 200000;
+    mt19937_64 rng(20240101);
+    string decimal = randomDigits(decimalLength, 10, rng);
+    string hex = randomDigits(hexLength, 16, rng);
+    BigInt value(decimal);
+
+    // toString(16) by div_1 passes only, then split at every level
+    // 只用 div_1 遍历执行 toString(16)，然后在每一层都拆分
+    BigInt hexValue = BigInt::fromString(hex, 16);
+    BigIntTuning radixTuning = BigInt::getTuning();
+    size_t splitThreshold = radixTuning.radixSplitThreshold;
+    radixTuning.radixSplitThreshold = SIZE_MAX;
+    BigInt::setTuning(radixTuning);
+    double passTime = timeOnce([&]() { string printed = hexValue.toString(16); });
+    radixTuning.radixSplitThreshold = 0;
+    BigInt::setTuning(radixTuning);
+    double splitTime = timeOnce([&]() { string printed = hexValue.toString(16); });
+    radixTuning.radixSplitThreshold = splitThreshold;
+    BigInt::setTuning(radixTuning);
+    cout << "hex print: div_1 " << passTime << " s, divide-and-conquer " << splitTime << " s" << '\n';
+
+    size_t hardwareThreads = max<unsigned>(1, thread::hardware_concurrency());
+    double baseline[4] = {0, 0, 0, 0};
+    for (size_t threads = 1; threads <= hardwareThreads; threads *= 2)
+    {
+        // Parallel conversion for every length, with the given number of threads. The hex print splits at every
+        // level so that its halves run on the threads
+        // 所有长度都使用给定线程数并行转换。十六进制输出在每一层都拆分，使其两半在多个线程上运行
+        BigIntTuning tuning = BigInt::getTuning();
+        tuning.parallelConversionThreshold = 0;
+        tuning.conversionThreads = threads;
+        tuning.radixSplitThreshold = 0;
+        BigInt::setTuning(tuning);
+
+        double times[4];
+        times[0] = timeOnce([&]() { BigInt parsed(decimal); });
+        times[1] = timeOnce([&]() { string printed = value.toString(); });
+        times[2] = timeOnce([&]() { BigInt parsed = BigInt::fromString(hex, 16); });
+        times[3] = timeOnce([&]() { string printed = hexValue.toString(16); });
+        if (threads == 1)
+        {
+            copy(times, times + 4, baseline);
+        }
+        cout << threads << " threads: decimal parse " << times[0] << " s (x" << baseline[0] / times[0]
+             << "), decimal print " << times[1] << " s (x" << baseline[1] / times[1]
+             << "), hex parse " << times[2] << " s (x" << baseline[2] / times[2]
+             << "), hex print " << times[3] << " s (x" << baseline[3] / times[3] << ")" << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include "BigInt.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+/**
+ * @brief Generates a random odd positive number with the given number of digits.
+ * 生成指定位数的随机正奇数。
+ *
+ * @param length Number of digits.位数。
+ * @param rng Random number generator.随机数生成器。
+ * @return BigInt
+ */
+BigInt randomOdd(size_t length, mt19937_64 &rng)
+{
+    uniform_int_distribution<int> digit(0, 9);
+    string value;
+    value.push_back(static_cast<char>('1' + digit(rng) % 9));
+    for (size_t i = 1; i < length; ++i)
+    {
+        value.push_back(static_cast<char>('0' + digit(rng)));
+    }
+    value.back() = static_cast<char>('1' + 2 * (digit(rng) % 5));
+    return BigInt(value);
+}
+
+/**
+ * @brief Arnault's 397-digit composite p1 * p2 * p3, with p2 = 313 (p1 - 1) + 1 and p3 = 353 (p1 - 1) + 1.
+ * It is a strong pseudoprime to every prime base below 307, so a test with fixed small bases accepts it.
+ * Arnault 构造的397位合数 p1 * p2 * p3，其中 p2 = 313 (p1 - 1) + 1，p3 = 353 (p1 - 1) + 1。
+ * 它对所有小于307的素数底数都是强伪素数，因此使用固定小底数的测试会接受它。
+ *
+ * @return BigInt
+ */
+BigInt arnaultComposite()
+{
+    BigInt p1("29674495668685510550154174642905332730771991799853043350995075531276838753171770199594238596428121188033664754218345562493168782883");
+    BigInt p2 = BigInt(313) * (p1 - 1) + 1;
+    BigInt p3 = BigInt(353) * (p1 - 1) + 1;
+    return p1 * p2 * p3;
+}
+
+/**
+ * @brief Measures how many random candidates isProbablePrime tests per second, and how long
+ * nextPrime takes, for several sizes.
+ * Usage: bench_prime [candidates per size], the default is 500.
+ * Before timing it checks that Arnault's composite is rejected.
+ * 测量不同位数下 isProbablePrime 每秒测试的随机候选数，以及 nextPrime 的耗时。
+ * 用法：bench_prime [每种位数的候选数]，默认为 500。
+ * 计时之前先检查 Arnault 构造的合数被拒绝。
+ */
+int main(int argc, char *argv[])
+{
+    size_t candidates = argc > 1 ? strtoull(argv[1], nullptr, 10) : 500;
+    if (arnaultComposite().isProbablePrime())
+    {
+        cout << "Arnault's composite passed the primality test" << '\n';
+        return 1;
+    }
+    mt19937_64 rng(20240101);
+    for (size_t length : {50, 100, 300, 1000})
+    {
+        vector<BigInt> values;
+        for (size_t i = 0; i < candidates; ++i)
+        {
+            values.push_back(randomOdd(length, rng));
+        }
+
+        size_t primes = 0;
+        auto start = chrono::steady_clock::now();
+        for (const BigInt &value : values)
+        {
+            primes += value.isProbablePrime() ? 1 : 0;
+        }
+        double testTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        start = chrono::steady_clock::now();
+        BigInt prime = values[0].nextPrime();
+        double nextTime = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << length << " digits: " << candidates / testTime << " candidates/s (" << primes << " probable primes of "
+             << candidates << "), nextPrime " << nextTime * 1e3 << " ms" << '\n';
+    }
+    return 0;
+}
@@ -1,10 +1,44 @@
 #include "BigInt.hpp"
+#include "BigIntAccumulator.hpp"
+#include "BigIntStore.hpp"
+#include "Equation.hpp"
+#include "EvalServer.hpp"
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <cstring>
+#include <cstdlib>
 
 using namespace std;
 
+/**
+ * @brief Utility function to display a number in base 10, or in base 16 with a 0x prefix.
+ * 工具函数，以十进制显示数字，或以带0x前缀的十六进制显示。
+ *
+ * @param os Output stream.输出流。
+ * @param value Number.数字。
+ * @param base 10 or 16.10或16。
+ */
+void numberOutput(ostream &os, const BigInt &value, int base)
+{
+    if (base == 16)
+    {
+        string hex = value.toString(16);
+        if (hex[0] == '-')
+        {
+            os << "-0x" << hex.substr(1);
+        }
+        else
+        {
+            os << "0x" << hex;
+        }
+    }
+    else
+    {
+        os << value;
+    }
+}
+
 /**
  * @brief Utility function to display user's equation.
  * 工具函数，显示用户算式。
@@ -12,167 +46,377 @@ using namespace std;
  * @param os Output stream.输出流。
  * @param operands Operands.操作数。
  * @param op Operator.运算符。 
+ * @param base Output base.输出进制。
  */
-void equationOutput(ostream &os, vector<BigInt> operands, char op)
+void equationOutput(ostream &os, const vector<BigInt> &operands, char op, int base)
 {
-    os << operands[0] << " " << op << " " << operands[1] << " = ";
+    numberOutput(os, operands[0], base);
+    for (size_t i = 1; i < operands.size(); ++i)
+    {
+        os << " " << op << " ";
+        numberOutput(os, operands[i], base);
+    }
+    os << " = ";
 }
 
 /**
- * @brief Parses and executes an equation.
- * 解析并执行算式。
+ * @brief Prints an evaluated equation and its result.
+ * 输出已求值的算式及其结果。
+ *
+ * @param os Output stream for the results.结果输出流。
+ * @param equation The equation.算式。
+ * @param result Its result.算式的结果。
+ * @param outputBase Base the numbers are printed in, 10 or 16.输出数字的进制，10或16。
+ */
+void printEquation(ostream &os, const Equation &equation, const BigInt &result, int outputBase)
+{
+    // Primality test, printed in function form
+    // 素性测试，以函数形式输出
+    if (equation.op == 'p')
+    {
+        os << equation.opName << "(";
+        numberOutput(os, equation.operands[0], outputBase);
+        os << ") = ";
+    }
+    // Unary - operator
+    // 一元-运算符
+    else if (equation.op == '-' && equation.operands.size() == 1)
+    {
+        os << equation.op << " ";
+        numberOutput(os, equation.operands[0], outputBase);
+        os << " = ";
+    }
+    else
+    {
+        equationOutput(os, equation.operands, equation.op, outputBase);
+    }
+    // '\n' instead of endl: flushing is left to the stream buffer
+    // 使用'\n'而不是endl：刷新交给流缓冲区决定
+    numberOutput(os, result, outputBase);
+    os << '\n';
+}
+
+/**
+ * @brief Parses and executes an equation. Syntax and arity errors are reported through the status of
+ * tryParse / tryEvaluate, other exceptions are caught and reported for the line, so the run continues.
+ * 解析并执行算式。语法和参数个数错误通过 tryParse / tryEvaluate 的状态报告，其他异常被捕获并报告该行，
+ * 因此运行会继续。
  *
  * @param line The line of input.输入行。
  * @param lineNumber The line number in the input file.文件中的行号。
+ * @param os Output stream for the results.结果输出流。
+ * @param outputBase Base the numbers are printed in, 10 or 16.输出数字的进制，10或16。
  */
-void parseAndExecute(const string &line, int lineNumber)
+void parseAndExecute(const string &line, int lineNumber, ostream &os = cout, int outputBase = 10)
 {
+    // Reused between lines so the operand vector keeps its capacity
+    // 在各行之间复用，使操作数数组保留其容量
+    static thread_local Equation equation;
+    static thread_local BigInt result;
     try
     {
-        // If the line is empty, throw an exception.
-        // 空文件则抛出异常
-        if (line.empty())
+        EquationStatus status = tryParse(line, lineNumber, equation);
+        if (status.ok())
         {
-            throw runtime_error("Empty line in line " + lineNumber);
+            status = tryEvaluate(equation, result);
         }
-
-        // Operator
-        // 运算符
-        char op = line[0];
-        // Check for legality of the operator.
-        // 运算符合法性判断
-        if (!(line[0] == '+' || line[0] == '-' || line[0] == '*'))
+        if (!status.ok())
         {
-            throw runtime_error("Illegal input or operator");
+            cerr << "Error in " << status.message() << '\n';
+            return;
         }
-        // Extract contents within parentheses.
-        // 提取括号内的内容
-        string operandsStr = line.substr(2, line.size() - 3);
+        printEquation(os, equation, result, outputBase);
+    }
+    catch (const exception &e)
+    {
+        // Other failures, such as running out of memory, end only this line
+        // 其他错误（例如内存不足）只结束这一行
+        cerr << "Error in line " << lineNumber << ": " << e.what() << '\n';
+    }
+}
+
+/**
+ * @brief File input mode.
+ * 文件输入模式。
+ *
+ * @param filePath The path of the file.文件路径。
+ * @param os Output stream for the results.结果输出流。
+ * @param outputBase Base the numbers are printed in.输出数字的进制。
+ */
+void fileInputMode(const string &filePath, ostream &os = cout, int outputBase = 10)
+{
+    ifstream file(filePath);
+    if (!file)
+    {
+        cerr << "Error opening file: " << filePath << endl;
+        return;
+    }
+    string line;
+    int lineNumber = 1;
+    while (getline(file, line))
+    {
+        parseAndExecute(line, lineNumber++, os, outputBase);
+    }
+}
 
-        stringstream ss(operandsStr);
-        string operand;
-        vector<BigInt> operands;
+/**
+ * @brief Stream input mode, reads equations line by line from an input stream.
+ * 流输入模式，从输入流中逐行读取算式。
+ *
+ * @param is Input stream.输入流。
+ * @param os Output stream for the results.结果输出流。
+ * @param outputBase Base the numbers are printed in.输出数字的进制。
+ */
+void streamInputMode(istream &is, ostream &os, int outputBase)
+{
+    string line;
+    int lineNumber = 1;
+    while (getline(is, line))
+    {
+        parseAndExecute(line, lineNumber++, os, outputBase);
+    }
+}
 
-        // Parse operands.
-        // 解析操作数
-        while (getline(ss, operand, ','))
-        {
-            // Check for empty string.
-            // 检查是否为空字符串
-            if (operand.empty())
-            {
-                throw std::runtime_error("Empty operand");
-            }
+/**
+ * @brief Executes the equations of a binary equation in memory.
+ * The data starts with the 8-byte magic "BIGINTE1" and the equation count (8 bytes, little-endian).
+ * Each equation has an 8-byte header: byte 0 is the operation ('+', '-', '*', 's' for sum or 'p' for isprime),
+ * bytes 1-3 are reserved and must be 0, and bytes 4-7 the operand count (little-endian), followed by the operand
+ * records in the BigIntStore record format. No text is parsed.
+ * 执行内存中二进制算式数据的算式。
+ * 数据以8字节魔数 "BIGINTE1" 和算式个数（8字节，小端）开头。
+ * 每个算式有8字节的头：第0字节为运算（'+'、'-'、'*'、表示sum的's'或表示isprime的'p'），
+ * 第1-3字节保留且必须为0，第4-7字节为操作数个数（小端），之后是 BigIntStore 记录格式的操作数记录。不解析任何文本。
+ *
+ * @param data
+ * @param size
+ * @param source Name of the input in error messages.错误信息中的输入名称。
+ * @param os Output stream for the results.结果输出流。
+ * @param outputBase Base the numbers are printed in.输出数字的进制。
+ */
+void executeBinary(const uint8_t *data, size_t size, const string &source, ostream &os, int outputBase)
+{
+    static const char MAGIC[8] = {'B', 'I', 'G', 'I', 'N', 'T', 'E', '1'};
+    static const size_t EQUATION_HEADER_SIZE = 8;
 
-            // Check for validity (only digits and an optional single negative sign).
-            // 检查合法性（仅数字和可选的单个负号）
-            bool isNegative = (operand[0] == '-');
-            if (isNegative && operand.size() == 1)
-            {
-                throw std::runtime_error("Invalid operand: '-' without number");
-            }
-            if (isNegative && operand[1] == '0')
-            {
-                // If the user inputs -0, treat it as 0.
-                // 如果用户输入了-0，则按照0来处理
-                if (operand.size() == 2)
-                {
-                    operand = "0";
-                }
-                else
-                {
-                    throw std::runtime_error("Invalid operand: negative number starts with 0");
-                }
-            }
-            for (size_t i = isNegative ? 1 : 0; i < operand.size(); ++i)
-            {
-                if (!std::isdigit(operand[i]))
-                {
-                    throw std::runtime_error("Invalid character in operand");
-                }
-            }
-            // Initialize as a BigInt and store.
-            // 初始化为BigInt并储存
-            operands.push_back(BigInt(operand));
-        }
+    if (size < 16 || memcmp(data, MAGIC, sizeof(MAGIC)) != 0)
+    {
+        cerr << "Error in file " << source << ": not a binary equation file" << endl;
+        return;
+    }
+    uint64_t equationCount = 0;
+    for (int i = 0; i < 8; ++i)
+    {
+        equationCount |= static_cast<uint64_t>(data[8 + i]) << (8 * i);
+    }
 
-        // Check the number and type of operands.
-        // 检查操作数数量和类型
-        if ((op == '+' || op == '*') && operands.size() != 2)
+    size_t position = 16;
+    Equation parsed;
+    for (uint64_t equation = 1; equation <= equationCount; ++equation)
+    {
+        if (size - position < EQUATION_HEADER_SIZE)
         {
-            throw runtime_error("Invalid number of operands");
+            cerr << "Error in equation " << equation << ": truncated file" << endl;
+            return;
         }
-        // The - operator can be unary or binary.
-        //-运算符可以是一元的，也可以是二元的
-        if (op == '-' && (operands.size() < 1 || operands.size() > 2))
+        char op = static_cast<char>(data[position]);
+        if (data[position + 1] != 0 || data[position + 2] != 0 || data[position + 3] != 0)
         {
-            throw runtime_error("Invalid number of operands");
+            cerr << "Error in equation " << equation << ": unsupported header, reserved bytes are not 0" << endl;
+            return;
         }
+        uint32_t operandCount = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            operandCount |= static_cast<uint32_t>(data[position + 4 + i]) << (8 * i);
+        }
+        position += EQUATION_HEADER_SIZE;
 
-        // Execute the operation.
-        // 执行运算
-        BigInt result;
-        switch (op)
+        // A bad operand record means the next equation cannot be found, so the file ends there
+        // 操作数记录有误时无法找到下一个算式，因此文件到此结束
+        parsed.operands.clear();
+        for (uint32_t i = 0; i < operandCount; ++i)
         {
-        case '+':
-            equationOutput(cout, operands, op);
-            result = operands[0] + operands[1];
-            break;
-        case '-':
-            // Unary - operator
-            // 一元-运算符
-            if (operands.size() == 1)
+            BigIntView view;
+            size_t consumed = 0;
+            if (!BigIntView::parse(data + position, size - position, view, consumed))
             {
-                cout << op << " " << operands[0] << " = ";
-                result = -operands[0];
+                cerr << "Error in equation " << equation << ": malformed operand record" << endl;
+                return;
             }
-            // Binary - operator
-            // 二元-运算符
-            else
-            {
-                equationOutput(cout, operands, op);
-                result = operands[0] - operands[1];
-            }
-            break;
-        case '*':
-            equationOutput(cout, operands, op);
-            result = operands[0] * operands[1];
-            break;
-        default:
-            throw runtime_error("Unsupported operator");
+            parsed.operands.push_back(view.toBigInt());
+            position += consumed;
         }
 
-        cout << result << endl;
-    }
-    catch (const exception &e)
-    {
-        cerr << "Error in line " << lineNumber << ": " << e.what() << endl;
+        parsed.opName = op == 's' ? "sum" : op == 'p' ? "isprime" : string(1, op);
+        parsed.op = op == 's' ? '+' : op;
+        parsed.line = static_cast<int>(equation);
+        BigInt result;
+        EquationStatus status = tryEvaluate(parsed, result);
+        if (status.ok())
+        {
+            printEquation(os, parsed, result, outputBase);
+        }
+        else
+        {
+            cerr << "Error in equation " << equation << ": " << status.reason() << '\n';
+        }
     }
 }
 
 /**
- * @brief File input mode.
- * 文件输入模式。
+ * @brief Binary input mode, executes the equations of a binary equation file.
+ * The file is memory-mapped, see executeBinary for the format.
+ * 二进制输入模式，执行二进制算式文件中的算式。文件通过内存映射读取，格式见 executeBinary。
  *
  * @param filePath The path of the file.文件路径。
+ * @param os Output stream for the results.结果输出流。
+ * @param outputBase Base the numbers are printed in.输出数字的进制。
  */
-void fileInputMode(const string &filePath)
+void binaryInputMode(const string &filePath, ostream &os, int outputBase)
 {
-    ifstream file(filePath);
-    if (!file)
+    MappedFile file;
+    if (!file.open(filePath))
     {
         cerr << "Error opening file: " << filePath << endl;
         return;
     }
-    string line;
-    int lineNumber = 1;
-    while (getline(file, line))
+    executeBinary(file.data(), file.size(), filePath, os, outputBase);
+}
+
+/**
+ * @brief Binary stream input mode. A stream cannot be mapped, so it is read into memory first.
+ * 二进制流输入模式。流无法映射，因此先读入内存。
+ *
+ * @param is Input stream.输入流。
+ * @param os Output stream for the results.结果输出流。
+ * @param outputBase Base the numbers are printed in.输出数字的进制。
+ */
+void binaryStreamInputMode(istream &is, ostream &os, int outputBase)
+{
+    static const size_t READ_CHUNK_SIZE = 1 << 16;
+    vector<uint8_t> data;
+    while (is)
+    {
+        size_t used = data.size();
+        data.resize(used + READ_CHUNK_SIZE);
+        is.read(reinterpret_cast<char *>(data.data() + used), READ_CHUNK_SIZE);
+        data.resize(used + static_cast<size_t>(is.gcount()));
+    }
+    executeBinary(data.data(), data.size(), "<stdin>", os, outputBase);
+}
+
+/**
+ * @brief Non-interactive pipeline mode: no prompts, results go to stdout through a large buffer.
+ * Reads from the given files in order, or from stdin when no file (or "-") is given.
+ * Each line is executed as soon as it is read, so results stream out while input is still arriving.
+ * 非交互式管道模式：没有提示，结果通过大缓冲区写入stdout。
+ * 按顺序读取给定的文件，没有给定文件（或给定"-"）时读取stdin。
+ * 每读到一行就立即执行，所以输入还没读完时结果就可以开始输出。
+ *
+ * @param files Input files.输入文件。
+ * @param outputBase Base the numbers are printed in.输出数字的进制。
+ * @param binary Whether the files (and stdin) are binary equation files.文件（以及stdin）是否为二进制算式文件。
+ */
+void pipelineMode(const vector<string> &files, int outputBase, bool binary)
+{
+    // Size of the stdout buffer
+    // stdout缓冲区大小
+    static const size_t OUTPUT_BUFFER_SIZE = 1 << 20;
+    static char outputBuffer[OUTPUT_BUFFER_SIZE];
+
+    // Detach from C stdio and untie cin, so reading input never flushes cout
+    // 与C stdio解除同步并解除cin的绑定，这样读取输入时不会刷新cout
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+    // The buffer must be installed before anything is written
+    // 必须在写入任何内容之前设置缓冲区
+    cout.rdbuf()->pubsetbuf(outputBuffer, OUTPUT_BUFFER_SIZE);
+
+    if (files.empty())
     {
-        parseAndExecute(line, lineNumber++);
+        if (binary)
+        {
+            binaryStreamInputMode(cin, cout, outputBase);
+        }
+        else
+        {
+            streamInputMode(cin, cout, outputBase);
+        }
+    }
+    for (const string &filePath : files)
+    {
+        if (binary && filePath == "-")
+        {
+            binaryStreamInputMode(cin, cout, outputBase);
+        }
+        else if (binary)
+        {
+            binaryInputMode(filePath, cout, outputBase);
+        }
+        else if (filePath == "-")
+        {
+            streamInputMode(cin, cout, outputBase);
+        }
+        else
+        {
+            fileInputMode(filePath, cout, outputBase);
+        }
     }
+    cout.flush();
 }
 
 
+/**
+ * @brief Server mode: evaluates equations sent over a Unix domain socket, one per line, until the
+ * process is stopped. Each response line is what pipeline mode would print for the equation, or
+ * the error message. The tuning profile and the per-thread buffers stay warm between requests.
+ * 服务器模式：对通过 Unix 域套接字发送的算式（每行一个）求值，直到进程被停止。每行响应
+ * 与管道模式对该算式的输出相同，或为错误信息。调优配置和线程内的缓冲区在请求之间保持。
+ *
+ * @param socketPath Path of the socket.套接字路径。
+ * @param workers Number of worker threads, 0 for one per hardware thread.工作线程数，0表示每个硬件线程一个。
+ * @param outputBase Base the numbers are printed in.输出数字的进制。
+ * @return false The socket could not be opened. 无法打开套接字。
+ */
+bool serverMode(const string &socketPath, size_t workers, int outputBase)
+{
+    // Load the tuning profile before the first request arrives
+    // 在第一个请求到达之前加载调优配置
+    BigInt::getTuning();
+    EvalServer server(
+        [outputBase](const string &request, uint64_t requestNumber, string &response)
+        {
+            thread_local Equation equation;
+            thread_local BigInt result;
+            thread_local ostringstream os;
+            EquationStatus status = tryParse(request, static_cast<int>(requestNumber), equation);
+            if (status.ok())
+            {
+                status = tryEvaluate(equation, result);
+            }
+            if (!status.ok())
+            {
+                response = "Error in " + status.message();
+                return false;
+            }
+            os.str("");
+            printEquation(os, equation, result, outputBase);
+            response = os.str();
+            response.pop_back();
+            return true;
+        },
+        workers);
+    if (!server.listen(socketPath))
+    {
+        cerr << "Error listening on socket: " << socketPath << endl;
+        return false;
+    }
+    cerr << "Listening on " << socketPath << endl;
+    server.run();
+    return true;
+}
+
 /**
  * @brief Demonstration mode.
  * 演示模式。
@@ -183,7 +427,8 @@ void demoMode()
     cout<<"Default constructor: "<<BigInt()<<endl;
     cout<<"Constructor that takes signed 64-bit integer: "<<BigInt(-234343246)<<endl;
     cout<<"Constructor that takes string: "<<BigInt("-23948723487901461543613452341325325")<<endl;
-    cout<<"Constructor that takes another BigInt: "<<BigInt(BigInt("22222222222244444444"))<<endl<<endl;
+    cout<<"Constructor that takes another BigInt: "<<BigInt(BigInt("22222222222244444444"))<<endl;
+    cout<<"Compile-time literal: "<<-23948723487901461543613452341325325_big<<endl<<endl;
     
     cout<<"Addition: "<<endl;
     cout<<"234326685623523 + 980927189936952374194 = "<<BigInt(234326685623523)+BigInt("980927189936952374194")<<endl;
@@ -222,12 +467,72 @@ void demoMode()
     test2=test1;
     cout<<"Assign with another BigInt: test2 = test1: "<<test2<<endl<<endl;
 
+    cout<<"Binary records: "<<endl;
+    for(const char *text : {"007", "00", "", "-0"})
+    {
+        vector<uint8_t> record;
+        serialize(BigInt(text), record);
+        cout<<"BigInt(\""<<text<<"\") -> "<<record.size()<<" bytes -> "<<deserialize(record.data(), record.size())<<endl;
+    }
+    cout<<endl;
+
 
 
 }
 
 int main(int argc, char *argv[])
 {
+    // Pipeline mode: demo --pipe [--hex] [--binary] [file ...]
+    // 管道模式：demo --pipe [--hex] [--binary] [file ...]
+    if (argc > 1 && strcmp(argv[1], "--pipe") == 0)
+    {
+        int firstFile = 2;
+        int outputBase = 10;
+        bool binary = false;
+        for (; firstFile < argc; ++firstFile)
+        {
+            if (strcmp(argv[firstFile], "--hex") == 0)
+            {
+                outputBase = 16;
+            }
+            else if (strcmp(argv[firstFile], "--binary") == 0)
+            {
+                binary = true;
+            }
+            else
+            {
+                break;
+            }
+        }
+        pipelineMode(vector<string>(argv + firstFile, argv + argc), outputBase, binary);
+        return 0;
+    }
+
+    // Server mode: demo --serve <socket path> [--workers N] [--hex]
+    // 服务器模式：demo --serve <套接字路径> [--workers N] [--hex]
+    if (argc > 1 && strcmp(argv[1], "--serve") == 0)
+    {
+        if (argc < 3 || strncmp(argv[2], "--", 2) == 0)
+        {
+            cerr << "Usage: " << argv[0] << " --serve <socket path> [--workers N] [--hex]" << endl;
+            return 1;
+        }
+        size_t workers = 0;
+        int outputBase = 10;
+        for (int i = 3; i < argc; ++i)
+        {
+            if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+            {
+                workers = strtoul(argv[++i], nullptr, 10);
+            }
+            else if (strcmp(argv[i], "--hex") == 0)
+            {
+                outputBase = 16;
+            }
+        }
+        return serverMode(argv[2], workers, outputBase) ? 0 : 1;
+    }
+
     string mode;
     cout << "Enter mode (enter 1 for demo mode, 2 for file mode): ";
     cin >> mode;
@@ -0,0 +1,119 @@
+#include "BigInt.hpp"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace std;
+
+/**
+ * @brief Generates a random positive number with the given number of digits.
+ * 生成指定位数的随机正数。
+ *
+ * @param length Number of digits.位数。
+ * @param rng Random number generator.随机数生成器。
+ * @return BigInt
+ */
+BigInt randomBigInt(size_t length, mt19937_64 &rng)
+{
+    uniform_int_distribution<int> digit(0, 9);
+    string value;
+    // The leading digit must not be 0
+    // 最高位不能为0
+    value.push_back(static_cast<char>('1' + digit(rng) % 9));
+    for (size_t i = 1; i < length; ++i)
+    {
+        value.push_back(static_cast<char>('0' + digit(rng)));
+    }
+    return BigInt(value);
+}
+
+/**
+ * @brief Measures the average time of one multiplication with the given thresholds.
+ * 测量在给定阈值下一次乘法的平均耗时。
+ *
+ * @param a
+ * @param b
+ * @param tuning Thresholds to use.使用的阈值。
+ * @return double Seconds per multiplication.每次乘法的秒数。
+ */
+double timeMultiplication(const BigInt &a, const BigInt &b, const BigIntTuning &tuning)
+{
+    BigInt::setTuning(tuning);
+    // Repeat until the measurement lasts long enough to be reliable
+    // 重复执行直到测量时间足够长，保证结果可靠
+    const double minimumTime = 0.02;
+    size_t iterations = 0;
+    auto start = chrono::steady_clock::now();
+    double elapsed = 0;
+    do
+    {
+        BigInt product = a;
+        product *= b;
+        ++iterations;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (elapsed < minimumTime);
+    return elapsed / iterations;
+}
+
+/**
+ * @brief Finds the Karatsuba crossover: the smallest length at which one level of Karatsuba
+ * beats schoolbook multiplication at that length and the next one.
+ * 寻找 Karatsuba 切换点：一层 Karatsuba 在该长度及下一个长度上都比手算乘法快的最小长度。
+ *
+ * @param rng Random number generator.随机数生成器。
+ * @return size_t
+ */
+size_t findKaratsubaThreshold(mt19937_64 &rng)
+{
+    const size_t minimumLength = 8;
+    const size_t maximumLength = 1024;
+    const size_t step = 8;
+    bool previousFaster = false;
+    for (size_t length = minimumLength; length <= maximumLength; length += step)
+    {
+        BigInt a = randomBigInt(length, rng);
+        BigInt b = randomBigInt(length, rng);
+
+        BigIntTuning schoolbook = BigInt::defaultTuning();
+        schoolbook.karatsubaThreshold = length + 1;
+        BigIntTuning karatsuba = BigInt::defaultTuning();
+        karatsuba.karatsubaThreshold = length;
+
+        double schoolbookTime = timeMultiplication(a, b, schoolbook);
+        double karatsubaTime = timeMultiplication(a, b, karatsuba);
+        cout << "length " << length << ": schoolbook " << schoolbookTime * 1e6 << " us, karatsuba "
+             << karatsubaTime * 1e6 << " us" << '\n';
+
+        bool faster = karatsubaTime < schoolbookTime;
+        if (faster && previousFaster)
+        {
+            return length - step;
+        }
+        previousFaster = faster;
+    }
+    return maximumLength;
+}
+
+/**
+ * @brief Measures the crossover thresholds on this machine and writes a tuning profile.
+ * Usage: tune [profile path], the default path is bigint_tuning.txt.
+ * 测量本机的切换阈值并写入调优配置文件。
+ * 用法：tune [配置文件路径]，默认路径为 bigint_tuning.txt。
+ */
+int main(int argc, char *argv[])
+{
+    string path = argc > 1 ? argv[1] : "bigint_tuning.txt";
+    mt19937_64 rng(20240101);
+
+    BigIntTuning tuning = BigInt::defaultTuning();
+    tuning.karatsubaThreshold = findKaratsubaThreshold(rng);
+    cout << "karatsuba_threshold " << tuning.karatsubaThreshold << '\n';
+
+    if (!BigInt::saveTuning(path, tuning))
+    {
+        cerr << "Error writing tuning profile: " << path << endl;
+        return 1;
+    }
+    cout << "Tuning profile written to " << path << endl;
+    return 0;
+}